@@ -32,16 +32,27 @@ LIBART_COMPILER_SRC_FILES += \
     optimizing/artist/api/env/java_env.cc \
     optimizing/artist/api/env/codelib_environment.cc \
     optimizing/artist/api/env/codelib_symbols.cc \
+    optimizing/artist/api/env/signature_interner.cc \
     optimizing/artist/api/env/dexfile_environment.cc \
+    optimizing/artist/internal/env/symbol_cache.cc \
+    optimizing/artist/internal/env/method_flags_table.cc \
     optimizing/artist/api/injection/injection.cc \
+    optimizing/artist/api/injection/injection_snippet.cc \
     optimizing/artist/internal/injection/injection_visitor.cc \
     optimizing/artist/api/injection/parameter.cc \
     optimizing/artist/api/injection/target.cc \
     optimizing/artist/internal/injection/visitor_keys.cc \
+    optimizing/artist/internal/injection/injection_plan.cc \
+    optimizing/artist/internal/injection/target_index.cc \
+    optimizing/artist/internal/injection/injection_site_index.cc \
     optimizing/artist/api/injection/injection_artist.cc \
+    optimizing/artist/api/injection/fused_injection_artist.cc \
     optimizing/artist/api/modules/method_info.cc \
     optimizing/artist/api/modules/method_info_factory.cc \
     optimizing/artist/internal/utils/param_finder.cc \
+    optimizing/artist/internal/utils/dex_symbol_index.cc \
+    optimizing/artist/internal/utils/aho_corasick.cc \
+    optimizing/artist/internal/utils/method_signature_cache.cc \
     optimizing/artist/api/modules/module.cc \
     optimizing/artist/api/modules/module_manager.cc \
     optimizing/artist/api/io/verbose_printer.cc \
@@ -40,6 +40,8 @@ typedef size_t MethodVtableIdx;
 
 // method signature
 typedef string MethodSignature;
+// interned method signature, see SignatureInterner
+typedef uint32_t SignatureId;
 typedef string ClassSignature;
 }  // namespace art
 
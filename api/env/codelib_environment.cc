@@ -22,6 +22,7 @@
  */
 
 #include <iomanip>
+#include <limits>
 #include "class_linker.h"
 
 #include "driver/compiler_driver-inl.h"
@@ -32,68 +33,241 @@
 #include "optimizing/artist/api/io/error_handler.h"
 
 using std::make_shared;
+using std::move;
+using std::numeric_limits;
 
 namespace art {
 
+const MethodVtableIdx CodeLibEnvironment::INVALID_VTABLE_IDX = numeric_limits<MethodVtableIdx>::max();
+
 // codelib will be deleted in destructor
 CodeLibEnvironment::CodeLibEnvironment(shared_ptr<const DexfileEnvironment> dexfile_env,
                                        const DexFile *codelib_dex_file, shared_ptr<const CodeLib> codelib,
-                                       jobject jclass_loader)
-        : _codelib_dex(codelib_dex_file), _codelib(codelib), _jclass_loader(jclass_loader), _instance_offset(art::MemberOffset(0)) {
-  for (auto dex_file : dexfile_env->getAppDexFiles()) {
-    auto symbols = make_shared<CodelibSymbols>(dex_file, codelib, jclass_loader);
-    _symbols[dex_file] = symbols;
+                                       jobject jclass_loader, shared_ptr<const FilesystemHelper> fs)
+        : _codelib_dex(codelib_dex_file), _codelib(codelib), _static_methods(codelib->usesStaticMethods()),
+          _instance_idx(CachedSymbols::INVALID_IDX), _jclass_loader(jclass_loader),
+          _instance_offset(art::MemberOffset(0)), _dex_cache(nullptr), _kill_switch(nullptr) {
+  // the symbol cache is optional since fs access is not always supported
+  if (fs != nullptr) {
+    _symbol_cache = make_shared<const SymbolCache>(fs->getTmpPath(), codelib);
   }
 
-  Locks::mutator_lock_->SharedLock(Thread::Current());
-  // init _class_linker
-  _class_linker = Runtime::Current()->GetClassLinker();
+  // symbols are only created on first use, see getCodelibSymbols. Here, we only register the candidate dex files so
+  // that the map does not change anymore once compilation starts.
+  for (auto dex_file : dexfile_env->getAppDexFiles()) {
+    _symbols[dex_file].reset(new LazySymbols());
+  }
 
-#ifdef BUILD_MARSHMALLOW
-  // mutex is released in destructor
-  ReaderMutexLock mu(Thread::Current(), *_class_linker->DexLock());
-#endif
-  // init class loader
-  ScopedObjectAccess soa(Thread::Current());
-  StackHandleScope<2> hs(soa.Self());
-  _class_loader = hs.NewHandle(soa.Decode<mirror::ClassLoader*>(_jclass_loader));
+  resolveCodelibSymbols();
+  resolveRuntimeSymbols();
+}
 
-  Locks::mutator_lock_->SharedUnlock(Thread::Current());
+/**
+ * Resolves the codelib's class def, type, instance field and method indices in the codelib dex file, either from the
+ * symbol cache or, on a cache miss, from the dex file itself.
+ */
+void CodeLibEnvironment::resolveCodelibSymbols() {
+  CachedSymbols cached;
+  if (_symbol_cache != nullptr && _symbol_cache->load(_codelib_dex, SymbolCache::CODELIB_DEX, &cached)) {
+    _cld_idx = cached.class_def_idx;
+    _type_idx = cached.type_idx;
+    _instance_idx = cached.instance_field_idx;
+    _codelib_method_idx = move(cached.method_idx);
+    resolveFieldIdxs();
+    return;
+  }
 
   // init class def index
-  auto codelib_class = codelib->getCodeClass();
-  if (!ArtUtils::FindClassDefIdxFromName(codelib_dex_file, codelib_class, &_cld_idx)) {
+  auto codelib_class = _codelib->getCodeClass();
+  if (!ArtUtils::FindClassDefIdxFromName(_codelib_dex, codelib_class, &_cld_idx)) {
     auto msg("Could not find ClassDefId for class: " + codelib_class);
     ErrorHandler::abortCompilation(msg);
   }
 
   // init type index
-//  _type_idx = ArtUtils::FindTypeIdxFromName(*codelib_dex_file, _codelib->getCodeClass());
-
-  if (!ArtUtils::FindTypeIdxFromName(codelib_dex_file, codelib_class, &_type_idx)) {
+  if (!ArtUtils::FindTypeIdxFromName(_codelib_dex, codelib_class, &_type_idx)) {
     auto msg("Could not find type " + codelib_class);
     ErrorHandler::abortCompilation(msg);
   }
 
-  // init singleton instance field index
-//  _instance_idx = ArtUtils::FindFieldIdxFromName(*codelib_dex_file, _codelib->getInstanceField());
+  // init singleton instance field index, static codelib methods do not need an instance
   auto instance_field = _codelib->getInstanceField();
-  if (!ArtUtils::FindFieldIdxFromName(codelib_dex_file, instance_field, &_instance_idx)) {
+  if (!_static_methods && !ArtUtils::FindFieldIdxFromName(_codelib_dex, instance_field, &_instance_idx)) {
     auto msg("Could not find type " + instance_field);
     ErrorHandler::abortCompilation(msg);
   }
+
+  // init method indices (in the codelib dex file)
+  map<MethodSignature, MethodIdx> method_idx;
+  vector<MethodSignature> missing;
+  if (!ArtUtils::FindMethodIdxs(_codelib_dex, _codelib->getMethods(), &method_idx, &missing)) {
+    string msg("Could not find method idx for");
+    for (auto && signature : missing) {
+      msg += " " + signature;
+    }
+    ErrorHandler::abortCompilation(msg);
+  }
+  setCodelibMethodIdxs(method_idx);
+  resolveFieldIdxs();
+
+  if (_symbol_cache != nullptr) {
+    cached.class_def_idx = _cld_idx;
+    cached.type_idx = _type_idx;
+    cached.instance_field_idx = _instance_idx;
+    cached.method_idx = _codelib_method_idx;
+    _symbol_cache->store(_codelib_dex, SymbolCache::CODELIB_DEX, cached);
+  }
+}
+
+/**
+ * Registers the codelib's static fields with their indices in the codelib dex file. Offsets and types are filled in
+ * when the runtime symbols are resolved.
+ */
+void CodeLibEnvironment::resolveFieldIdxs() {
+  auto fields = _codelib->getFields();
+  if (!_codelib->getKillSwitch().empty()) {
+    fields.insert(_codelib->getKillSwitch());
+  }
+  for (auto && field : fields) {
+    FieldIdx field_idx;
+    if (!ArtUtils::FindFieldIdxFromName(_codelib_dex, field, &field_idx)) {
+      auto msg("Could not find codelib field " + field);
+      ErrorHandler::abortCompilation(msg);
+    }
+    _fields.emplace(field, CodelibField { field_idx, MemberOffset(0), Primitive::kPrimVoid, false });
+  }
+}
+
+void CodeLibEnvironment::setCodelibMethodIdxs(const map<MethodSignature, MethodIdx>& method_idx) {
+  _codelib_method_idx = SignatureInterner::getInstance().toTable<MethodIdx>(method_idx, CachedSymbols::INVALID_IDX);
+}
+
+/**
+ * Captures everything about the codelib that requires runtime objects, i.e., the codelib's dex cache, the offset of the
+ * singleton instance field and the vtable indices of all codelib methods. This is the only place where the environment
+ * accesses the runtime, so the mutator lock is taken a single time and all getters are plain reads that are safe to
+ * call from any compiler thread.
+ */
+void CodeLibEnvironment::resolveRuntimeSymbols() {
+#ifdef BUILD_MARSHMALLOW
+  // Marshmallow lacks an invoke that resolves its target independent of the dex pc (@see ArtUtils::InjectMethodCall)
+  if (_static_methods) {
+    ErrorHandler::abortCompilation("Static codelib methods are not supported on Marshmallow");
+  }
+#endif
+  ScopedObjectAccess soa(Thread::Current());
+  _class_linker = Runtime::Current()->GetClassLinker();
+#ifdef BUILD_MARSHMALLOW
+  // released at the end of this scope
+  ReaderMutexLock mu(soa.Self(), *_class_linker->DexLock());
+#endif
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::ClassLoader> class_loader(hs.NewHandle(soa.Decode<mirror::ClassLoader*>(_jclass_loader)));
+#ifdef BUILD_MARSHMALLOW
+  Handle<mirror::DexCache> dex_cache(hs.NewHandle(_class_linker->FindDexCache(*_codelib_dex)));
+#else
+  Handle<mirror::DexCache> dex_cache(hs.NewHandle(_class_linker->FindDexCache(soa.Self(), *_codelib_dex, false)));
+#endif
+
+  // keep a global reference instead of looking the dex cache up again for each method. Handles to it are created in
+  // the handle scope of the compiled method (@see MethodInfo::GetCodeLibDexCache), since instructions keep them.
+  _dex_cache = soa.Env()->NewGlobalRef(soa.AddLocalReference<jobject>(dex_cache.Get()));
+
+  // init instance offset
+  if (!_static_methods) {
+    const bool IS_STATIC = true;
+    ArtField* resolved_field = _class_linker->ResolveField(*_codelib_dex, _instance_idx, dex_cache, class_loader,
+                                                           IS_STATIC);
+    if (resolved_field == nullptr) {
+      auto msg = "Could not resolve codelib instance field for dex file " + _codelib_dex->GetLocation();
+      ArtUtils::DumpFields(*_codelib_dex);
+      ErrorHandler::abortCompilation(msg);
+    }
+    _instance_offset = resolved_field->GetOffset();
+  }
+
+  // init static fields
+  for (auto && entry : _fields) {
+    const bool IS_STATIC = true;
+    ArtField* resolved_field = _class_linker->ResolveField(*_codelib_dex, entry.second.field_idx, dex_cache,
+                                                           class_loader, IS_STATIC);
+    if (resolved_field == nullptr) {
+      auto msg = "Could not resolve codelib field " + entry.first + " for dex file " + _codelib_dex->GetLocation();
+      ErrorHandler::abortCompilation(msg);
+    }
+    entry.second.offset = resolved_field->GetOffset();
+    entry.second.type = resolved_field->GetTypeAsPrimitiveType();
+    entry.second.is_volatile = resolved_field->IsVolatile();
+  }
+  if (!_codelib->getKillSwitch().empty()) {
+    _kill_switch = &getField(_codelib->getKillSwitch());
+    if (_kill_switch->type != Primitive::kPrimBoolean) {
+      ErrorHandler::abortCompilation("The codelib kill switch " + _codelib->getKillSwitch() + " is not a boolean");
+    }
+  }
+
+  // init vtable indices
+  auto pointer_size = _class_linker->GetImagePointerSize();
+  _method_vtable_idx.assign(_codelib_method_idx.size(), INVALID_VTABLE_IDX);
+  for (SignatureId id = 0; id < _codelib_method_idx.size(); id++) {
+    MethodIdx method_idx = _codelib_method_idx[id];
+    // the id space is shared with other codelibs, so there are gaps for signatures we do not provide
+    if (method_idx == CachedSymbols::INVALID_IDX) {
+      continue;
+    }
+    ArtMethod* resolved_method = dex_cache->GetResolvedMethod(method_idx, pointer_size);
+    if (resolved_method == nullptr) {
+      auto msg = "Could not resolve method " + SignatureInterner::getInstance().resolve(id) + " for dex file "
+                 + _codelib_dex->GetLocation();
+      ErrorHandler::abortCompilation(msg);
+    }
+    // static methods are called directly and hence do not have a vtable index
+    if (_static_methods) {
+      if (!resolved_method->IsStatic()) {
+        auto msg = "Codelib method " + SignatureInterner::getInstance().resolve(id) + " is not static";
+        ErrorHandler::abortCompilation(msg);
+      }
+      continue;
+    }
+    _method_vtable_idx[id] = resolved_method->GetVtableIndex();
+  }
+  VLOG(artistd) << "CodeLibEnvironment: resolved instance field offset and vtable indices of "
+                << _codelib->getMethods().size() << " codelib methods";
 }
 
 const DexFile* CodeLibEnvironment::getDexFile() const {
   return _codelib_dex;
 }
 
+shared_ptr<const CodeLib> CodeLibEnvironment::getCodeLib() const {
+  return _codelib;
+}
+
+/**
+ * @return whether codelib methods are called directly, without the instance (@see CodeLib::usesStaticMethods)
+ */
+bool CodeLibEnvironment::usesStaticMethods() const {
+  return _static_methods;
+}
+
+/**
+ * Provides the codelib symbols for the given app dex file. They are created lazily by the first thread that asks for
+ * them (others are blocked until they are published), so dex files that never host instrumented methods are not
+ * parsed at all.
+ *
+ * @return codelib symbols for dex_file or nullptr if dex_file is not an app dex file
+ */
 shared_ptr<const CodelibSymbols> CodeLibEnvironment::getCodelibSymbols(const DexFile* dex_file) const {
   auto result = _symbols.find(dex_file);
   if (result == _symbols.end()) {
     return nullptr;
   }
-  return result->second;
+  LazySymbols* entry = result->second.get();
+  call_once(entry->flag, [this, entry, dex_file]() {
+    VLOG(artistd) << "CodeLibEnvironment: creating codelib symbols for " << dex_file->GetLocation();
+    entry->symbols = make_shared<const CodelibSymbols>(dex_file, _codelib, _symbol_cache);
+  });
+  return entry->symbols;
 }
 
 ClassDefIdx CodeLibEnvironment::getClassDefIdx() const {
@@ -110,101 +284,80 @@ FieldIdx CodeLibEnvironment::getInstanceFieldIdx() const {
 
 /**
  * Provides the offset to the codelib's static singleton instance field.
- * The offset is initialized lazily a single time so that consecutive calls will function as a pure getter.
  *
  * @return MemberOffset to singleton instance field.
  */
-MemberOffset CodeLibEnvironment::getInstanceFieldOffset() {
-  // lazy init: executed only by the first thread (others are blocked) and ignored for consecutive calls.
-  call_once(offset_flag, [this]() {this->_instance_offset = this->findInstanceFieldOffset();});
-
-  // after the initial setup, this function simply returns the already computed offset
+MemberOffset CodeLibEnvironment::getInstanceFieldOffset() const {
   return _instance_offset;
 }
 
 /**
- * Provides the index to the codelib's vtable for a given method signature.
+ * Provides the codelib's dex cache as a JNI global reference. It needs to be decoded while holding the mutator lock,
+ * so use MethodInfo::GetCodeLibDexCache to obtain a handle for the method under compilation.
  *
- * @return vtable index for the given signature.
+ * @return global reference to the codelib's dex cache.
  */
-MethodVtableIdx CodeLibEnvironment::getMethodVtableIdx(const MethodSignature& signature) {
-  if (methodVtableIdx.find(signature) == methodVtableIdx.end()) {
-    methodVtableIdx[signature] = this->findMethodVtableIdx(signature);
-  }
-  return methodVtableIdx[signature];
+jobject CodeLibEnvironment::getDexCache() const {
+  return _dex_cache;
 }
 
 /**
- * Finds the offset of the codelib's static singleton instance field.
+ * Provides the index to the codelib's vtable for a given method signature.
+ * All indices are resolved in the constructor, so this is a plain read that is safe to call from any thread.
  *
- * @return MemberOffset to the codelib's singleton field.
+ * @return vtable index for the given signature.
  */
-MemberOffset CodeLibEnvironment::findInstanceFieldOffset() const {
-  // init dex file cache
-  Locks::mutator_lock_->SharedLock(Thread::Current());
-  StackHandleScope<2> hs(Thread::Current());
-
-#ifdef BUILD_MARSHMALLOW
-  auto codelib_dex_cache = hs.NewHandle(_class_linker->FindDexCache(*_codelib_dex));
-#else
-  auto codelib_dex_cache = hs.NewHandle(_class_linker->FindDexCache(Thread::Current(), *_codelib_dex, false));
-#endif
+MethodVtableIdx CodeLibEnvironment::getMethodVtableIdx(SignatureId signature) const {
+  if (signature >= _method_vtable_idx.size() || _method_vtable_idx[signature] == INVALID_VTABLE_IDX) {
+    auto msg("Could not find method idx for " + SignatureInterner::getInstance().resolve(signature));
+    ErrorHandler::abortCompilation(msg);
+  }
+  return _method_vtable_idx[signature];
+}
 
-  // init instance offset
-  CHECK(_class_linker != nullptr);
-  ArtField* resolved_field = _class_linker->ResolveField(*_codelib_dex,
-                                                         _instance_idx,
-                                                         codelib_dex_cache,
-                                                         _class_loader,
-                                                         false);
-  if (resolved_field == nullptr) {
-    auto msg = "Could not resolve codelib instance field for dex file " + _codelib_dex->GetLocation();
-    ArtUtils::DumpFields(*_codelib_dex);
+MethodVtableIdx CodeLibEnvironment::getMethodVtableIdx(const MethodSignature& signature) const {
+  SignatureId id;
+  if (!SignatureInterner::getInstance().lookup(signature, &id)) {
+    auto msg("Could not find method idx for " + signature);
     ErrorHandler::abortCompilation(msg);
-  } else {
-    auto result = resolved_field->GetOffset();
-    Locks::mutator_lock_->SharedUnlock(Thread::Current());
-    return result;
   }
+  return getMethodVtableIdx(id);
 }
 
 /**
- * Finds the vtable index for a particular codelib function.
- *
- * @return the vtable index for the given signature.
+ * Provides a static codelib field (@see CodeLib::getFields), aborts if the codelib does not declare it.
  */
-MethodVtableIdx CodeLibEnvironment::findMethodVtableIdx(const MethodSignature& signature) const {
-  ScopedObjectAccess soa(Thread::Current());
-#ifdef BUILD_MARSHMALLOW
-  // released in destructor
-  ReaderMutexLock mu(Thread::Current(), *_class_linker->DexLock());
-#endif
-  // get all the required objects
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-  StackHandleScope<2> hs(soa.Self());
-  Handle<mirror::ClassLoader> class_loader(hs.NewHandle(soa.Decode<mirror::ClassLoader*>(_jclass_loader)));
-#ifdef BUILD_MARSHMALLOW
-  Handle<mirror::DexCache> dex_cache(hs.NewHandle(class_linker->FindDexCache(*_codelib_dex)));
-#else
-  Handle<mirror::DexCache> dex_cache(hs.NewHandle(class_linker->FindDexCache(Thread::Current(), *_codelib_dex, false)));
-#endif
-
-  MethodIdx method_idx;
-  if (!ArtUtils::FindMethodIdx(_codelib_dex, signature, &method_idx)) {
-    auto msg("Could not find method idx for " + signature);
+const CodelibField& CodeLibEnvironment::getField(const string& field) const {
+  auto found = _fields.find(field);
+  if (found == _fields.end()) {
+    auto msg("Unknown codelib field " + field + ", it needs to be declared in CodeLib::getFields()");
     ErrorHandler::abortCompilation(msg);
   }
+  return found->second;
+}
 
-  ArtMethod* resolved_method = dex_cache->GetResolvedMethod(method_idx, class_linker->GetImagePointerSize());
+bool CodeLibEnvironment::hasKillSwitch() const {
+  return _kill_switch != nullptr;
+}
 
-  size_t index = 0;
-  if (resolved_method == nullptr) {
-    auto msg = "Could not resolve method " + signature + " for dex file " + _codelib_dex->GetLocation();
+/**
+ * Provides the codelib's kill switch field (@see CodeLib::getKillSwitch). Only valid if hasKillSwitch().
+ */
+const CodelibField& CodeLibEnvironment::getKillSwitch() const {
+  CHECK(_kill_switch != nullptr);
+  return *_kill_switch;
+}
+
+/**
+ * Provides the index of a codelib method in the codelib dex file, as opposed to the index of its method id in an app
+ * dex file (@see CodelibSymbols::getMethodIdx).
+ */
+MethodIdx CodeLibEnvironment::getCodelibMethodIdx(SignatureId signature) const {
+  if (signature >= _codelib_method_idx.size() || _codelib_method_idx[signature] == CachedSymbols::INVALID_IDX) {
+    auto msg("Could not find method idx for " + SignatureInterner::getInstance().resolve(signature));
     ErrorHandler::abortCompilation(msg);
-  } else {
-    index = resolved_method->GetVtableIndex();
   }
-  return index;
+  return _codelib_method_idx[signature];
 }
 
 }  // namespace art
@@ -24,24 +24,43 @@
 #ifndef ART_API_ENV_CODELIB_ENVIRONMENT_H_
 #define ART_API_ENV_CODELIB_ENVIRONMENT_H_
 
+#include <memory>
 #include <string>
 #include <mutex>
+#include <vector>
 
 #include "codelib_symbols.h"
+#include "handle.h"
 #include "offsets.h"
 #include "optimizing/artist/api/modules/codelib.h"
 #include "class_linker.h"
 #include "dexfile_environment.h"
 #include "artist_typedefs.h"
+#include "signature_interner.h"
+#include "optimizing/artist/api/io/filesystem_helper.h"
+#include "optimizing/artist/internal/env/symbol_cache.h"
 
 using std::map;
 using std::once_flag;
 using std::call_once;
 using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
 
 namespace art {
 
 class CodelibSymbols;
+
+/**
+ * A static codelib field as it is needed to access it from injected code (@see CodeLib::getFields).
+ */
+struct CodelibField {
+  FieldIdx field_idx;
+  MemberOffset offset;
+  Primitive::Type type;
+  bool is_volatile;
+};
+
 /**
  * Provides information about a corresponding codelib that is needed to, e.g., inject calls to codelib methods or use
  * its fields. It will initialize all data either in the constructor or lazily when required and then act as a pure
@@ -50,42 +69,67 @@ class CodelibSymbols;
 class CodeLibEnvironment {
  public:
   explicit CodeLibEnvironment(shared_ptr<const DexfileEnvironment> dexfile_env, const DexFile* codelib_dex_file,
-                              shared_ptr<const CodeLib> codelib, jobject jclass_loader);
+                              shared_ptr<const CodeLib> codelib, jobject jclass_loader,
+                              shared_ptr<const FilesystemHelper> fs = nullptr);
 
   const DexFile* getDexFile() const;
+  shared_ptr<const CodeLib> getCodeLib() const;
+  bool usesStaticMethods() const;
   shared_ptr<const CodelibSymbols> getCodelibSymbols(const DexFile* dex_file) const;
 
   ClassDefIdx getClassDefIdx() const;
   TypeIdx getTypeIdx() const;
   FieldIdx getInstanceFieldIdx() const;
-  MemberOffset getInstanceFieldOffset();
-  MethodVtableIdx getMethodVtableIdx(const MethodSignature& signature);
+  MemberOffset getInstanceFieldOffset() const;
+  jobject getDexCache() const;
+  MethodVtableIdx getMethodVtableIdx(SignatureId signature) const;
+  MethodVtableIdx getMethodVtableIdx(const MethodSignature& signature) const;
+  MethodIdx getCodelibMethodIdx(SignatureId signature) const;
+  const CodelibField& getField(const string& field) const;
+  bool hasKillSwitch() const;
+  const CodelibField& getKillSwitch() const;
 
  private:
-  MemberOffset findInstanceFieldOffset() const;
-  MethodVtableIdx findMethodVtableIdx(const MethodSignature& signature) const;
+  static const MethodVtableIdx INVALID_VTABLE_IDX;
+
+  void resolveCodelibSymbols();
+  void setCodelibMethodIdxs(const map<MethodSignature, MethodIdx>& method_idx);
+  void resolveFieldIdxs();
+  void resolveRuntimeSymbols();
 
  private:
   const DexFile* _codelib_dex;
   shared_ptr<const CodeLib> _codelib;
+  const bool _static_methods;
 
   // initialized in constructor
   ClassDefIdx _cld_idx;
   TypeIdx _type_idx;
   FieldIdx _instance_idx;
   jobject _jclass_loader;
-  map<const DexFile*, shared_ptr<CodelibSymbols>> _symbols;
-  Handle<mirror::ClassLoader> _class_loader;
+  // lazily created codelib symbols for a single app dex file
+  struct LazySymbols {
+    once_flag flag;
+    shared_ptr<const CodelibSymbols> symbols;
+  };
+  // keys are registered in the constructor and never change afterwards, hence lookups do not need locking
+  map<const DexFile*, unique_ptr<LazySymbols>> _symbols;
+  // codelib method indices in the codelib dex file, indexed by signature id
+  vector<MethodIdx> _codelib_method_idx;
+  // nullable: persists resolved symbols across compiler runs
+  shared_ptr<const SymbolCache> _symbol_cache;
   ClassLinker* _class_linker;
 
-
-  map<const MethodSignature, MethodVtableIdx> methodVtableIdx;
-
-  // lazily initialized
+  // runtime symbols, immutable after construction
+  // indexed by signature id
+  vector<MethodVtableIdx> _method_vtable_idx;
+  // static fields, keys are registered while resolving the codelib symbols
+  map<string, CodelibField> _fields;
   MemberOffset _instance_offset;
-
-  // lock guard flags for lazily initialized values
-  once_flag offset_flag;
+  // JNI global reference, i.e., a GC root that stays valid even if the dex cache is moved
+  jobject _dex_cache;
+  // nullable, points into _fields
+  const CodelibField* _kill_switch;
 };
 
 }  // namespace art
@@ -22,10 +22,22 @@
 #include "codelib_symbols.h"
 #include "optimizing/artist/api/io/error_handler.h"
 
+using std::move;
+
 namespace art {
 
-CodelibSymbols::CodelibSymbols(const DexFile* dex_file, shared_ptr<const CodeLib> codelib, jobject jclass_loader)
+CodelibSymbols::CodelibSymbols(const DexFile* dex_file, shared_ptr<const CodeLib> codelib,
+                               shared_ptr<const SymbolCache> cache)
         : _dex_file(dex_file) {
+  // only dex data is parsed here, so no runtime locks are required and symbols for different dex files can be created
+  // concurrently.
+  CachedSymbols cached;
+  if (cache != nullptr && cache->load(dex_file, SymbolCache::APP_DEX, &cached)) {
+    _type_idx = cached.type_idx;
+    _method_idx = move(cached.method_idx);
+    return;
+  }
+
   // init type index
   auto codelib_class = codelib->getCodeClass();
   if (!ArtUtils::FindTypeIdxFromName(dex_file, codelib_class, &_type_idx)) {
@@ -33,27 +45,23 @@ CodelibSymbols::CodelibSymbols(const DexFile* dex_file, shared_ptr<const CodeLib
     ErrorHandler::abortCompilation(msg);
   }
 
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-#ifdef BUILD_MARSHMALLOW
-  // released in destructor
-  ReaderMutexLock mu(Thread::Current(), *class_linker->DexLock());
-#endif
-  // get all the required objects
-  ScopedObjectAccess soa(Thread::Current());
-  StackHandleScope<2> hs(soa.Self());
-  Handle<mirror::ClassLoader> class_loader(hs.NewHandle(soa.Decode<mirror::ClassLoader*>(jclass_loader)));
-#ifdef BUILD_MARSHMALLOW
-  Handle<mirror::DexCache> dex_cache(hs.NewHandle(class_linker->FindDexCache(*dex_file)));
-#else
-  Handle<mirror::DexCache> dex_cache(hs.NewHandle(class_linker->FindDexCache(Thread::Current(), *dex_file, false)));
-#endif
-
   // init method (vtable) indices
-  for (MethodSignature signature : codelib->getMethods()) {
-    if (!ArtUtils::FindMethodIdx(dex_file, signature, &(_method_idx[signature]))) {
-      auto msg("Could not find method idx for " + signature);
-      ErrorHandler::abortCompilation(msg);
+  map<MethodSignature, MethodIdx> method_idx;
+  vector<MethodSignature> missing;
+  if (!ArtUtils::FindMethodIdxs(dex_file, codelib->getMethods(), &method_idx, &missing)) {
+    string msg = "Could not find method idx in " + dex_file->GetLocation() + " for " + std::to_string(missing.size())
+                 + " method(s):";
+    for (auto && signature : missing) {
+      msg += " " + signature;
     }
+    ErrorHandler::abortCompilation(msg);
+  }
+  setMethodIdxs(method_idx);
+
+  if (cache != nullptr) {
+    cached.type_idx = _type_idx;
+    cached.method_idx = _method_idx;
+    cache->store(dex_file, SymbolCache::APP_DEX, cached);
   }
 }
 
@@ -66,13 +74,26 @@ TypeIdx CodelibSymbols::getTypeIdx() const {
   return _type_idx;
 }
 
-MethodIdx CodelibSymbols::getMethodIdx(MethodSignature signature) const {
-  auto result = _method_idx.find(signature);
-  if (result == _method_idx.end()) {
-      auto msg("CodelibSymbols: Failed obtaining method idx for signature " + signature);
+MethodIdx CodelibSymbols::getMethodIdx(SignatureId signature) const {
+  if (signature >= _method_idx.size() || _method_idx[signature] == CachedSymbols::INVALID_IDX) {
+    auto msg("CodelibSymbols: Failed obtaining method idx for signature "
+             + SignatureInterner::getInstance().resolve(signature));
     ErrorHandler::abortCompilation(msg);
   }
-  return result->second;
+  return _method_idx[signature];
+}
+
+MethodIdx CodelibSymbols::getMethodIdx(const MethodSignature& signature) const {
+  SignatureId id;
+  if (!SignatureInterner::getInstance().lookup(signature, &id)) {
+    auto msg("CodelibSymbols: Failed obtaining method idx for signature " + signature);
+    ErrorHandler::abortCompilation(msg);
+  }
+  return getMethodIdx(id);
+}
+
+void CodelibSymbols::setMethodIdxs(const map<MethodSignature, MethodIdx>& method_idx) {
+  _method_idx = SignatureInterner::getInstance().toTable<MethodIdx>(method_idx, CachedSymbols::INVALID_IDX);
 }
 
 }  // namespace art
@@ -34,7 +34,9 @@
 #include "codelib_environment.h"
 #include "optimizing/artist/api/utils/artist_utils.h"
 #include "artist_typedefs.h"
+#include "signature_interner.h"
 #include "optimizing/artist/api/modules/codelib.h"
+#include "optimizing/artist/internal/env/symbol_cache.h"
 
 
 using std::map;
@@ -45,25 +47,31 @@ namespace art {
 
 /**
  * Stores and provides dexfile-specific information about the codelib.
+ * Creating the symbols only requires the dex file itself but no runtime objects, hence it is safe to create symbols
+ * for several dex files in parallel. If a symbol cache is provided, previously resolved symbols are reused.
  */
 class CodelibSymbols {
  public:
-    CodelibSymbols(const DexFile* dex_file, shared_ptr<const CodeLib> codelib, jobject jclass_loader);
+    CodelibSymbols(const DexFile* dex_file, shared_ptr<const CodeLib> codelib,
+                   shared_ptr<const SymbolCache> cache = nullptr);
 
     const DexFile* getDexFile() const;
 
     TypeIdx getTypeIdx() const;
-    MethodIdx getMethodIdx(MethodSignature signature) const;
+    MethodIdx getMethodIdx(SignatureId signature) const;
+    MethodIdx getMethodIdx(const MethodSignature& signature) const;
 
 
  private:
+    void setMethodIdxs(const map<MethodSignature, MethodIdx>& method_idx);
+
     const DexFile* _dex_file;
 
     // the codelib type index in the given dexfile
     TypeIdx _type_idx;
 
-    // codelib method indices in the given dexfile
-    map<MethodSignature, MethodIdx> _method_idx;
+    // codelib method indices in the given dexfile, indexed by signature id
+    vector<MethodIdx> _method_idx;
 };
 
 }  // namespace art
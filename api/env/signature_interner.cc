@@ -0,0 +1,72 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "signature_interner.h"
+#include "optimizing/artist/api/io/error_handler.h"
+
+using std::lock_guard;
+
+namespace art {
+
+const SignatureId SignatureInterner::INVALID_ID = 0xFFFFFFFF;
+
+SignatureInterner& SignatureInterner::getInstance() {
+  // Automated creation and destruction through `static` modifier.
+  static SignatureInterner instance;
+  return instance;
+}
+
+SignatureId SignatureInterner::intern(const MethodSignature& signature) {
+  lock_guard<mutex> guard(_lock);
+  auto found = _ids.find(signature);
+  if (found != _ids.end()) {
+    return found->second;
+  }
+  auto id = static_cast<SignatureId>(_signatures.size());
+  _signatures.push_back(signature);
+  _ids.emplace(StringPiece(_signatures.back()), id);
+  return id;
+}
+
+bool SignatureInterner::lookup(const MethodSignature& signature, SignatureId* result) const {
+  lock_guard<mutex> guard(_lock);
+  auto found = _ids.find(signature);
+  if (found == _ids.end()) {
+    return false;
+  }
+  if (result) {
+    *result = found->second;
+  }
+  return true;
+}
+
+const MethodSignature& SignatureInterner::resolve(SignatureId id) const {
+  lock_guard<mutex> guard(_lock);
+  if (id >= _signatures.size()) {
+    ErrorHandler::abortCompilation("SignatureInterner: unknown signature id " + std::to_string(id));
+  }
+  return _signatures[id];
+}
+
+size_t SignatureInterner::size() const {
+  lock_guard<mutex> guard(_lock);
+  return _signatures.size();
+}
+
+}  // namespace art
@@ -0,0 +1,114 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_API_ENV_SIGNATURE_INTERNER_H_
+#define ART_API_ENV_SIGNATURE_INTERNER_H_
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "artist_typedefs.h"
+#include "optimizing/artist/internal/utils/dex_symbol_index.h"
+
+using std::deque;
+using std::map;
+using std::mutex;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * Maps method signatures to small, stable integer ids so that downstream tables can be plain arrays indexed by id
+ * instead of maps keyed by strings. Ids are dense and assigned in interning order, the first id being 0.
+ * Interned strings are never moved or released, so references returned by ``resolve`` stay valid.
+ *
+ * The singleton pattern is used because ids need to be consistent between all modules and compiler threads.
+ */
+class SignatureInterner {
+// singleton logic
+ public:
+  static SignatureInterner& getInstance();
+
+  explicit SignatureInterner(SignatureInterner const&) = delete;
+  explicit SignatureInterner(SignatureInterner &&) noexcept = delete;
+  void operator=(SignatureInterner const&)  = delete;
+  void operator=(SignatureInterner &&) noexcept = delete;
+  ~SignatureInterner() = default;
+
+ private:
+  SignatureInterner() {}
+
+// regular logic
+ public:
+  static const SignatureId INVALID_ID;
+
+  /**
+   * Provides the id for the given signature, assigning a new one if the signature is not yet known.
+   */
+  SignatureId intern(const MethodSignature& signature);
+
+  /**
+   * Provides the id for the given signature without assigning a new one.
+   *
+   * @return whether the signature was interned before
+   */
+  bool lookup(const MethodSignature& signature, SignatureId* result) const;
+
+  /**
+   * @return the signature for a previously assigned id
+   */
+  const MethodSignature& resolve(SignatureId id) const;
+
+  /**
+   * @return the number of assigned ids, i.e., an upper bound for all ids
+   */
+  size_t size() const;
+
+  /**
+   * Converts a signature-keyed map into a flat table indexed by signature id, interning all signatures on the way.
+   * Ids without an entry map to `invalid`.
+   */
+  template <typename T>
+  vector<T> toTable(const map<MethodSignature, T>& entries, T invalid) {
+    vector<T> table;
+    for (auto && entry : entries) {
+      auto id = intern(entry.first);
+      if (id >= table.size()) {
+        table.resize(id + 1, invalid);
+      }
+      table[id] = entry.second;
+    }
+    return table;
+  }
+
+ private:
+  mutable mutex _lock;
+  // deque: growing it does not move existing elements, hence the map's keys stay valid
+  deque<MethodSignature> _signatures;
+  unordered_map<StringPiece, SignatureId, StringPieceHash> _ids;
+};
+
+}  // namespace art
+
+#endif  // ART_API_ENV_SIGNATURE_INTERNER_H_
@@ -0,0 +1,88 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <array>
+
+#include "fused_injection_artist.h"
+#include "optimizing/artist/internal/injection/injection_visitor.h"
+
+using std::array;
+
+namespace art {
+
+HFusedInjectionArtist::HFusedInjectionArtist(const MethodInfo& method_info, const vector<HInjectionArtist*>& passes)
+    : HArtist(method_info
+#ifdef BUILD_MARSHMALLOW
+        , true
+#endif
+        , "FusedInjectionArtist")
+    , _passes(passes) {
+  CHECK(!_passes.empty());
+}
+
+void HFusedInjectionArtist::SetupPass() {
+  for (auto pass : _passes) {
+    pass->Setup();
+  }
+}
+
+void HFusedInjectionArtist::RunPass() {
+  VLOG(artistd) << "Run Pass " << this->GetPassName() << " (" << _passes.size() << " modules)";
+
+  // merged dispatch table: for each kind of site, the passes that have injections for it. Passes that cannot inject
+  // anything into this method are left out entirely.
+  array<vector<HInjectionArtist*>, VisitorKeys::NUM_KEYS> dispatch;
+  bool any_pass = false;
+  for (auto pass : _passes) {
+    if (!pass->GetInjectionPlan().MayHaveInjectionSites(&graph_->GetDexFile(), graph_->GetMethodIdx(),
+                                                        _method_info.GetCodeItem())) {
+      continue;
+    }
+    for (size_t key = 0; key < VisitorKeys::NUM_KEYS; key++) {
+      if (!pass->GetInjectionTableEntry(static_cast<VisitorKeys::Key>(key)).empty()) {
+        dispatch[key].push_back(pass);
+        any_pass = true;
+      }
+    }
+  }
+  if (!any_pass) {
+    VLOG(artistd) << "Run Pass SKIPPED: no injection sites";
+    return;
+  }
+
+  VisitorKeys::Key key;
+  for (HInstruction* instruction : _method_info.GetInjectionSites().GetSites()) {
+    // instructions might have been removed from the graph by a previous pass
+    if (instruction->GetBlock() == nullptr || !InjectionSiteIndex::GetKey(instruction, &key)) {
+      continue;
+    }
+    for (auto pass : dispatch[key]) {
+      // visitors are lightweight views on their pass, so we do not keep them around
+      HInjectionVisitor visitor(pass, graph_);
+      instruction->Accept(&visitor);
+    }
+  }
+  // each wrapped pass loads its own codelib instance, which is placed as the pass requests
+  for (auto pass : _passes) {
+    pass->PlaceCodeLib();
+  }
+  VLOG(artistd) << "Run Pass DONE";
+}
+
+}  // namespace art
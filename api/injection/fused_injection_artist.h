@@ -0,0 +1,54 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_API_INJECTION_FUSED_INJECTION_ARTIST_H_
+#define ART_API_INJECTION_FUSED_INJECTION_ARTIST_H_
+
+#include <vector>
+
+#include "optimizing/artist/api/injection/injection_artist.h"
+
+using std::vector;
+
+namespace art {
+
+/**
+ * Runs the injection passes of several modules on the same method in a single traversal.
+ *
+ * Each wrapped pass keeps its own injection plan, codelib environment and codelib instance, but the injection sites
+ * of the method are only iterated once: for each site, exactly the passes whose plans have injections for the site's
+ * kind are dispatched (merged dispatch table). Passes whose plans cannot match the method are dropped up front, so the
+ * per-method cost scales with the number of injection sites rather than with the number of modules.
+ *
+ * Fused passes are created by ModuleManager::createPasses for modules whose injection passes are adjacent.
+ */
+class HFusedInjectionArtist : public HArtist {
+ public:
+  HFusedInjectionArtist(const MethodInfo& method_info, const vector<HInjectionArtist*>& passes);
+
+  void SetupPass() OVERRIDE;
+  void RunPass() OVERRIDE;
+
+ private:
+  vector<HInjectionArtist*> _passes;
+};
+
+}  // namespace art
+
+#endif  // ART_API_INJECTION_FUSED_INJECTION_ARTIST_H_
@@ -22,6 +22,7 @@
 
 #include "injection.h"
 #include "parameter.h"
+#include "optimizing/artist/api/env/signature_interner.h"
 #include <iostream>
 
 using std::move;
@@ -32,13 +33,26 @@ Injection::Injection(const string &_signature,
                      vector<shared_ptr<const Parameter>> _parameter,
                      vector<shared_ptr<const Target>> _injection_target)
     : signature(_signature)
+    , signature_id(SignatureInterner::getInstance().intern(_signature))
     , parameters(_parameter)
-    , injection_targets(_injection_target) {}
+    , injection_targets(_injection_target)
+    , sampling_rate(1)
+    , loop_mode(EVERY_ITERATION) {}
+
+Injection::Injection(shared_ptr<const InjectionSnippet> _snippet,
+                     vector<shared_ptr<const Target>> _injection_target)
+    : signature()
+    , signature_id(SignatureInterner::INVALID_ID)
+    , parameters()
+    , injection_targets(_injection_target)
+    , snippet(_snippet)
+    , sampling_rate(1)
+    , loop_mode(EVERY_ITERATION) {}
 
 const string Injection::ToString() const {
   string string_ = "Injection: ";
 
-  string_ += (this->signature + " [WHAT] \n");
+  string_ += ((snippet != nullptr ? snippet->ToString() : this->signature) + " [WHAT] \n");
   for (auto && param : this->parameters) {
     string_ += ("> P: " + param->PrettyName() + ", \n");
   }
@@ -55,6 +69,10 @@ const string& Injection::GetSignature() const {
   return signature;
 }
 
+SignatureId Injection::GetSignatureId() const {
+  return signature_id;
+}
+
 const vector<shared_ptr<const Parameter>>& Injection::GetParameters() const {
   return parameters;
 }
@@ -63,6 +81,31 @@ const vector<shared_ptr<const Target>>& Injection::GetInjectionTargets() const {
   return injection_targets;
 }
 
+const shared_ptr<const InjectionSnippet>& Injection::GetSnippet() const {
+  return snippet;
+}
+
+void Injection::SetSampling(uint32_t rate, const string& counter_field) {
+  sampling_rate = rate;
+  sampling_counter = counter_field;
+}
+
+uint32_t Injection::GetSamplingRate() const {
+  return sampling_rate;
+}
+
+const string& Injection::GetSamplingCounter() const {
+  return sampling_counter;
+}
+
+void Injection::SetLoopMode(LoopMode mode) {
+  loop_mode = mode;
+}
+
+Injection::LoopMode Injection::GetLoopMode() const {
+  return loop_mode;
+}
+
 std::ostream& operator<<(std::ostream& os, const Injection& injection) {
   os << injection.ToString();
   return os;
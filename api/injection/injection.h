@@ -29,6 +29,8 @@
 #include <unordered_set>
 #include "target.h"
 #include "parameter.h"
+#include "injection_snippet.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
 
 using std::shared_ptr;
 using std::vector;
@@ -39,22 +41,63 @@ namespace art {
 
 class Injection {
  public:
+  /**
+   * How the injection is treated at call sites inside loops (@see SetLoopMode):
+   * - EVERY_ITERATION: the call is injected at each site, as everywhere else.
+   * - LOOP_INVARIANT: the call does not depend on the iteration, so it is made once in the pre-header of the outermost
+   *   loop instead of at its sites inside the loop. Note that the call is then made whenever the loop is entered, even
+   *   if the site itself is not reached.
+   * - AGGREGATE: counting injection. The codelib method takes the number of site executions as additional, last `int`
+   *   parameter. Sites in simple loops increment an in-register counter and the call is made once per loop exit.
+   *   Sites outside of loops, or in loops that are not simple, call it with a count of 1.
+   */
+  enum LoopMode { EVERY_ITERATION, LOOP_INVARIANT, AGGREGATE };
+
   Injection(const string& _signature,
             vector<shared_ptr<const Parameter>> _parameter,
             vector<shared_ptr<const Target>> _injection_target);
 
+  /**
+   * Creates an injection that splices the given snippet at its targets instead of calling a codelib method.
+   */
+  Injection(shared_ptr<const InjectionSnippet> _snippet,
+            vector<shared_ptr<const Target>> _injection_target);
+
   const string ToString() const;
 
   const string& GetSignature() const;
+  SignatureId GetSignatureId() const;
   const vector<shared_ptr<const Parameter>>& GetParameters() const;
   const vector<shared_ptr<const Target>>& GetInjectionTargets() const;
+  // nullptr for codelib calls
+  const shared_ptr<const InjectionSnippet>& GetSnippet() const;
+
+  /**
+   * Samples the injected codelib call: only one in `rate` executions of each site reaches the codelib, the others
+   * only decrement a countdown kept in the given static int codelib field (@see CodeLib::getFields) and skip the
+   * call. All sites of this injection share the counter. Has no effect on snippets and on rates below 2.
+   */
+  void SetSampling(uint32_t rate, const string& counter_field);
+  uint32_t GetSamplingRate() const;
+  const string& GetSamplingCounter() const;
+
+  void SetLoopMode(LoopMode mode);
+  LoopMode GetLoopMode() const;
 
  private:
   string signature;
+  SignatureId signature_id;
 
   vector<shared_ptr<const Parameter>> parameters;
 
   vector<shared_ptr<const Target>> injection_targets;
+
+  shared_ptr<const InjectionSnippet> snippet;
+
+  uint32_t sampling_rate;
+  string sampling_counter;
+
+  LoopMode loop_mode;
 };
 
 ostream& operator<<(ostream& os, const Injection& injection);
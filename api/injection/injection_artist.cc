@@ -20,8 +20,6 @@
  *
  */
 
-#include <atomic>
-
 #include "injection_artist.h"
 #include "optimizing/artist/api/io/artist_log.h"
 #include "optimizing/artist/internal/injection/injection_visitor.h"
@@ -43,106 +41,46 @@ using std::sort;
 namespace art {
 
 void HInjectionArtist::SetupPass() {
-    // get module-provided injections
-    this->_injections = ProvideInjections();
-    // fill our internal data structures
-    SetupInjections();  // FIXME this is horibly slow AND redundant since it is identical in each instance
-}
-
-void HInjectionArtist::SetupInjections() {
-    VLOG(artistd) << "SetupInjections()";
-
-//  VLOG(artist) << "HInjectionArtist::SetupInjections() InjectionCount Total #" << this->injections.size();
-  int32_t targetCounter = 0;
-  for (auto const injection : this->_injections) {
-      VLOG(artistd) << "HInjectionArtist::SetupInjections() Method:      " << injection->GetSignature();
-      auto injection_targets = injection->GetInjectionTargets();
-
-      VLOG(artistd) << "HInjectionArtist::SetupInjections() Local TargetCount  #" << injection_targets.size();
-      // TODO Bug: Using Injection with multiple targets that have the same InjectionTarget
-      //           Leads to duplicate injections
-      for (auto && target : injection_targets) {
-          switch ((int32_t)target->GetTargetType()) {
-              case InjectionTarget::METHOD_CALL_BEFORE:
-                  ++targetCounter;
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_INTERFACE, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_STATIC_OR_DIRECT, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_VIRTUAL, injection);
-                  break;
-              case InjectionTarget::METHOD_CALL_AFTER:
-                  ++targetCounter;
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_INTERFACE, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_STATIC_OR_DIRECT, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_INVOKE_VIRTUAL, injection);
-                  break;
-              case InjectionTarget::METHOD_START:
-                  ++targetCounter;
-                  this->EmplaceTableEntry(VisitorKeys::H_RETURN, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_RETURN_VOID, injection);
-                  break;
-              case InjectionTarget::METHOD_END:
-                  ++targetCounter;
-                  this->EmplaceTableEntry(VisitorKeys::H_RETURN, injection);
-                  this->EmplaceTableEntry(VisitorKeys::H_RETURN_VOID, injection);
-                  break;
-              case InjectionTarget::NO_INJECTION:
-              default:
-                  VLOG(artistd) << "Nothing to inject";
-                  continue;
-          }
-      }
-  }
-  VLOG(artistd) << "HInjectionArtist::SetupInjections() InjectionCount Total #" << this->_injections.size();
-  VLOG(artistd) << "HInjectionArtist::SetupInjections() TargetCount Total    #" << targetCounter;
-  VLOG(artistd) << "HInjectionArtist::SetupInjections() DONE";
-  VLOG(artistd) << endl;
+  // module-provided injections are identical for all instances of a pass, so they are only processed once per module.
+  _plan = InjectionPlan::Get(getCodeLibEnvironment().get(), getDexfileEnvironment()->getAppDexFiles(),
+                             [this]() { return ProvideInjections(); });
 }
 
-
 void HInjectionArtist::RunPass()  {
   VLOG(artistd) << "Run Pass " << this->GetPassName();
+  // most methods do not contain any injection site, so we check the method's code before visiting its graph. Code
+  // injected by earlier passes is deliberately ignored here, just like in the shared injection site index.
+  if (!_plan->MayHaveInjectionSites(&graph_->GetDexFile(), graph_->GetMethodIdx(), _method_info.GetCodeItem())) {
+    VLOG(artistd) << "Run Pass SKIPPED: no injection sites";
+    return;
+  }
   HInjectionVisitor injectionVisitor(this, graph_);
-  injectionVisitor.VisitInsertionOrder();
+  // only invokes and returns can be injection sites, so we do not need to visit all instructions
+  injectionVisitor.VisitSites(_method_info.GetInjectionSites());
   VLOG(artistd) << "Run Pass DONE";
 }
 
 // injection-specifics
 
-const vector<shared_ptr<const Injection>>& HInjectionArtist::GetInjections() {
-    VLOG(artistd) << "HInjectionArtist::GetInjections()";
-    return this->_injections;
+const vector<shared_ptr<const Injection>>& HInjectionArtist::GetInjections() const {
+  return _plan->GetInjections();
 }
 
-const unordered_map<string, vector<shared_ptr<const Injection>>>& HInjectionArtist::GetInjectionTable() {
-    return this->_injection_table;
+const InjectionPlan::InjectionTable& HInjectionArtist::GetInjectionTable() const {
+  return _plan->GetInjectionTable();
 }
 
-const vector<shared_ptr<const Injection>> HInjectionArtist::GetInjectionTableEntry(const string& callback_key) {
-  auto found_item = this->_injection_table.find(callback_key);
-  vector<shared_ptr<const Injection>> local_injections;
-  if (found_item == this->_injection_table.end()) {
-    return local_injections;
-  } else {
-    local_injections = this->_injection_table.at(callback_key);
-    return local_injections;
-  }
+const vector<shared_ptr<const Injection>>& HInjectionArtist::GetInjectionTableEntry(
+    VisitorKeys::Key callback_key) const {
+  return _plan->GetInjectionTableEntry(callback_key);
 }
 
-bool HInjectionArtist::EmplaceTableEntry(const string& callback_key, shared_ptr<const Injection> single_injection) {
-    VLOG(artistd) << "HInjectionArtist::EmplaceTableEntry()";
+const InjectionPlan& HInjectionArtist::GetInjectionPlan() const {
+  return *_plan;
+}
 
-    auto new_injections = GetInjectionTableEntry(callback_key);
-    VLOG(artistd) << "HInjectionArtist::EmplaceTableEntry() " << callback_key
-                  << " Table Contained    # " << new_injections.size();
-    new_injections.push_back(single_injection);
-    VLOG(artistd) << "HInjectionArtist::EmplaceTableEntry() " << callback_key
-                  << " Table Contains Now # " << new_injections.size();
-    this->_injection_table.erase(callback_key);
-    this->_injection_table.emplace(callback_key, new_injections);
-    VLOG(artistd) << "HInjectionArtist::EmplaceTableEntry() DONE";
-    return true;
+bool HInjectionArtist::ClaimLoopInjection(const Injection* injection, const HLoopInformation* loop) {
+  return _hoisted_injections.emplace(injection, loop).second;
 }
 
 }  // namespace art
@@ -23,10 +23,16 @@
 #ifndef ART_API_INJECTION_INJECTION_ARTIST_H_
 #define ART_API_INJECTION_INJECTION_ARTIST_H_
 
+#include <set>
+#include <utility>
+
 #include "optimizing/artist/api/modules/artist.h"
+#include "optimizing/artist/internal/injection/injection_plan.h"
 
-using std::unordered_map;
 using std::enable_shared_from_this;
+using std::pair;
+using std::set;
+using std::unordered_map;
 
 namespace art {
 
@@ -50,34 +56,44 @@ class HInjectionArtist : public HArtist {
 #endif
         , pass_name
         , stats)
-      , _injections {}
-      , _injection_table {} {}
+      , _plan {} {}
 
   // artist module interface
   void SetupPass() OVERRIDE;
   void RunPass() OVERRIDE;
 
-  const vector<shared_ptr<const Injection>>& GetInjections();
-  const unordered_map<string, vector<shared_ptr<const Injection>>>& GetInjectionTable();
-  const vector<shared_ptr<const Injection>> GetInjectionTableEntry(const string& callback_key);
-  bool EmplaceTableEntry(const string& callback_key, shared_ptr<const Injection> single_injection);
+  HInjectionArtist* AsInjectionArtist() OVERRIDE { return this; }
+
+  const vector<shared_ptr<const Injection>>& GetInjections() const;
+  const InjectionPlan::InjectionTable& GetInjectionTable() const;
+  const vector<shared_ptr<const Injection>>& GetInjectionTableEntry(VisitorKeys::Key callback_key) const;
+  const InjectionPlan& GetInjectionPlan() const;
+
+  /**
+   * Records that a loop-invariant injection is hoisted out of the given loop, so it is only hoisted once no matter how
+   * many of its sites the loop contains.
+   *
+   * @return whether this is the first claim for the injection and loop
+   */
+  bool ClaimLoopInjection(const Injection* injection, const HLoopInformation* loop);
 
  protected:
   /**
    * Provides a list of configurations that governs the process of injecting method calls.
    * This method defines what method calls the concrete module is injection and where.
+   * It is only invoked once per module, the resulting plan is shared by all pass instances (@see InjectionPlan).
    *
    * @return list of injection policies
    */
   virtual vector<shared_ptr<const Injection>> ProvideInjections() const = 0;
 
  private:
-  void SetupInjections();
-
-  vector<shared_ptr<const Injection>> _injections;
+  shared_ptr<const InjectionPlan> _plan;
+  // per-method state
+  set<pair<const Injection*, const HLoopInformation*>> _hoisted_injections;
 
-  // Use @see VisitorKeys
-  unordered_map<string, vector<shared_ptr<const Injection>>> _injection_table;
+  // sets up and runs the passes of several modules at once
+  friend class HFusedInjectionArtist;
 };
 
 }  // namespace art
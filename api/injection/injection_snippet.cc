@@ -0,0 +1,53 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "injection_snippet.h"
+#include "optimizing/nodes.h"
+#include "optimizing/artist/api/env/codelib_environment.h"
+#include "optimizing/artist/api/io/error_handler.h"
+#include "optimizing/artist/api/utils/artist_utils.h"
+
+namespace art {
+
+CounterSnippet::CounterSnippet(const string& field, int64_t delta)
+    : _field(field), _delta(delta) {}
+
+void CounterSnippet::Emit(HInstruction* instruction_cursor, shared_ptr<CodeLibEnvironment> env,
+                          const MethodInfo& method_info) const {
+  CHECK(instruction_cursor != nullptr);
+  const CodelibField& field = env->getField(_field);
+  if (field.type != Primitive::kPrimInt && field.type != Primitive::kPrimLong) {
+    ErrorHandler::abortCompilation("CounterSnippet: " + _field + " is neither an int nor a long field");
+  }
+  HBasicBlock* block = instruction_cursor->GetBlock();
+  HGraph* graph = block->GetGraph();
+
+  HInstruction* codelib_class = ArtUtils::InjectCodeLibClass(instruction_cursor, env);
+  HInstruction* value = ArtUtils::InjectStaticFieldGet(instruction_cursor, codelib_class, field, env, method_info);
+  HAdd* sum = new (graph->GetArena()) HAdd(field.type, value, graph->GetConstant(field.type, _delta));
+  block->InsertInstructionBefore(sum, instruction_cursor);
+  ArtUtils::InjectStaticFieldSet(instruction_cursor, codelib_class, field, sum, env, method_info);
+  VLOG(artistd) << "CounterSnippet::Emit() " << ToString();
+}
+
+string CounterSnippet::ToString() const {
+  return "CounterSnippet: " + _field + " += " + std::to_string(_delta);
+}
+
+}  // namespace art
@@ -0,0 +1,83 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_API_INJECTION_INJECTION_SNIPPET_H_
+#define ART_API_INJECTION_INJECTION_SNIPPET_H_
+
+#include <memory>
+#include <string>
+
+#include "base/macros.h"
+
+using std::shared_ptr;
+using std::string;
+
+namespace art {
+
+class CodeLibEnvironment;
+class HInstruction;
+class MethodInfo;
+
+/**
+ * Small IR template that is spliced directly into the instrumented method instead of calling out to the codelib.
+ * Meant for cheap instrumentation such as counters or flags, where an invoke would cost far more than the actual
+ * work. Since the emitted instructions are ordinary HIR nodes, the optimizations that run after ARTist treat them like
+ * the method's own code.
+ *
+ * Snippets are shared by all compiler threads, so they must not keep any per-method state.
+ */
+class InjectionSnippet {
+ public:
+  InjectionSnippet() {}
+  virtual ~InjectionSnippet() {}
+
+  /**
+   * Emits the snippet's instructions right before instruction_cursor.
+   *
+   * @param instruction_cursor the instruction the snippet is inserted in front of
+   * @param env the environment of the codelib whose static fields the snippet might access
+   * @param method_info the method the snippet is emitted into
+   */
+  virtual void Emit(HInstruction* instruction_cursor, shared_ptr<CodeLibEnvironment> env,
+                    const MethodInfo& method_info) const = 0;
+
+  virtual string ToString() const = 0;
+};
+
+/**
+ * Adds a constant to a static int or long codelib field (@see CodeLib::getFields), i.e., `field += delta`.
+ * The update is not atomic, so concurrent increments might get lost.
+ */
+class CounterSnippet : public InjectionSnippet {
+ public:
+  explicit CounterSnippet(const string& field, int64_t delta = 1);
+
+  void Emit(HInstruction* instruction_cursor, shared_ptr<CodeLibEnvironment> env,
+            const MethodInfo& method_info) const OVERRIDE;
+
+  string ToString() const OVERRIDE;
+
+ private:
+  const string _field;
+  const int64_t _delta;
+};
+
+}  // namespace art
+
+#endif  // ART_API_INJECTION_INJECTION_SNIPPET_H_
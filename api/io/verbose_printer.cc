@@ -33,7 +33,7 @@ namespace art {
       : StringPrettyPrinter(info.GetGraph()), methodInfo(info) { }
 
   VerbosePrinter::VerbosePrinter(HGraph* graph, const DexCompilationUnit& dex_compilation_unit)
-      : StringPrettyPrinter(graph), methodInfo(MethodInfoFactory::obtain(graph, dex_compilation_unit)) {}
+      : StringPrettyPrinter(graph), methodInfo(MethodInfoFactory::obtain(graph, dex_compilation_unit, nullptr)) {}
 
   void VerbosePrinter::VisitNewInstance(art::HNewInstance *instruction) {
     PrintPreInstruction(instruction);
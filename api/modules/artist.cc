@@ -59,6 +59,7 @@ HArtist::HArtist(const MethodInfo& method_info,
 #endif
                     pass_name, stats)
     , _codelib_instruction(nullptr)
+    , _codelib_placement(ENTRY_BLOCK)
     , _method_info(method_info) {
 }
 
@@ -96,9 +97,19 @@ void HArtist::Run() {
   VLOG(artistd) << std::endl;
   VLOG(artistd) << "Artist #" << _method_counter << ": " << method_signature<< " (" << dexFileName << ")";
 
+  const int32_t instruction_id = graph_->GetCurrentInstructionId();
   Setup();
   RunPass();
-  fixMaximumNumberOfOutVRegs(graph_);
+  PlaceCodeLib();
+  // injection helpers keep the maximum number of out vregs up to date, so the rescan only verifies them. A too small
+  // maximum results in a too small frame, hence it is checked in release builds as well, but only if the pass added
+  // any instructions, which most methods do not need.
+  if (graph_->GetCurrentInstructionId() != instruction_id) {
+    const uint16_t tracked = graph_->GetMaximumNumberOfOutVRegs();
+    fixMaximumNumberOfOutVRegs(graph_);
+    CHECK_EQ(tracked, graph_->GetMaximumNumberOfOutVRegs())
+        << "Invokes were added without ArtUtils::UpdateMaximumNumberOfOutVRegs in " << method_signature;
+  }
 }
 
 void HArtist::Setup() {
@@ -113,14 +124,21 @@ void HArtist::Setup() {
 HInstruction* HArtist::GetCodeLibInstruction(HInstruction *instruction_cursor) {
   if (this->_codelib_instruction == nullptr) {
     if (instruction_cursor == nullptr) {
-      this->_codelib_instruction = ArtUtils::InjectCodeLib(graph_->GetEntryBlock()->GetLastInstruction(), _codelib_env);
+      this->_codelib_instruction = ArtUtils::InjectCodeLib(graph_->GetEntryBlock()->GetLastInstruction(), _codelib_env,
+                                                           _method_info);
     } else {
-      this->_codelib_instruction = ArtUtils::InjectCodeLib(instruction_cursor, _codelib_env, false);
+      this->_codelib_instruction = ArtUtils::InjectCodeLib(instruction_cursor, _codelib_env, _method_info, false);
     }
   }
   return this->_codelib_instruction;
 }
 
+void HArtist::PlaceCodeLib() {
+  if (_codelib_placement == DOMINATOR && _codelib_instruction != nullptr) {
+    ArtUtils::SinkCodeLib(_codelib_instruction);
+  }
+}
+
 const MethodInfo& HArtist::GetMethodInfo() const {
   VLOG(artistd) << "HArtist::GetMethodInfo(): " << this->_method_info << std::flush;
   return this->_method_info;
@@ -149,4 +167,12 @@ shared_ptr<CodeLibEnvironment> HArtist::getCodeLibEnvironment() const {
   return _codelib_env;
 }
 
+void HArtist::setCodeLibPlacement(CodeLibPlacement placement) {
+  _codelib_placement = placement;
+}
+
+HArtist::CodeLibPlacement HArtist::getCodeLibPlacement() const {
+  return _codelib_placement;
+}
+
 }  // namespace art
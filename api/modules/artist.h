@@ -35,6 +35,7 @@ using std::shared_ptr;
 namespace art {
 
 class HGraph;
+class HInjectionArtist;
 class HInstruction;
 class DexCompilationUnit;
 class CompilerDriver;
@@ -48,6 +49,14 @@ class OptimizingCompilerStats;
  */
 class HArtist : public HOptimization {
  public:
+  /**
+   * Where the codelib instance is loaded (@see GetCodeLibInstruction):
+   * - ENTRY_BLOCK: once in the entry block, so every execution of the method pays for the load.
+   * - DOMINATOR: at the nearest common dominator of all its users, outside of loops and try blocks
+   *   (@see ArtUtils::SinkCodeLib), so paths without injection sites skip the load.
+   */
+  enum CodeLibPlacement { ENTRY_BLOCK, DOMINATOR };
+
   explicit HArtist(const MethodInfo& method_info,
 #ifdef BUILD_MARSHMALLOW
           bool is_in_ssa_form = true,
@@ -65,12 +74,21 @@ class HArtist : public HOptimization {
   void setCodeLibEnvironment(shared_ptr<CodeLibEnvironment> environment);
   shared_ptr<CodeLibEnvironment> getCodeLibEnvironment() const;
 
+  void setCodeLibPlacement(CodeLibPlacement placement);
+  CodeLibPlacement getCodeLibPlacement() const;
+
   void Run() OVERRIDE;
 
+  /**
+   * @return this pass if it is an injection pass (@see HInjectionArtist), else nullptr
+   */
+  virtual HInjectionArtist* AsInjectionArtist() { return nullptr; }
+
  private:
   HInstruction* _codelib_instruction;
   shared_ptr<const DexfileEnvironment> _dexfile_env;
   shared_ptr<CodeLibEnvironment> _codelib_env;
+  CodeLibPlacement _codelib_placement;
 
  protected:
   const MethodInfo& _method_info;
@@ -80,6 +98,12 @@ class HArtist : public HOptimization {
  protected:
   void Setup();
 
+  /**
+   * Moves the codelib instance load to its final position according to the codelib placement. Needs to be called
+   * after all injections into the method are done.
+   */
+  void PlaceCodeLib();
+
   // Module API
 
   /**
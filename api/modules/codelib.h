@@ -25,9 +25,11 @@
 
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 using std::unordered_set;
 using std::string;
+using std::vector;
 
 namespace art {
 
@@ -40,6 +42,48 @@ class CodeLib {
   virtual unordered_set<string>& getMethods() const = 0;
   virtual string& getInstanceField() const = 0;
   virtual string& getCodeClass() const = 0;
+
+  /**
+   * Opt-in static dispatch: if true, all codelib methods are declared static and injected as static calls.
+   * Injected calls then neither load the singleton instance (getInstanceField() is ignored) nor need a null check
+   * or a virtual dispatch. Each call initializes the codelib class explicitly and enters the callee through the
+   * runtime's static invoke trampoline, which resolves it by method index. Not supported on Marshmallow.
+   */
+  virtual bool usesStaticMethods() const { return false; }
+
+  /**
+   * Static codelib fields that injected code accesses directly, e.g., counters updated by an InjectionSnippet.
+   * Uses the same notation as getInstanceField().
+   */
+  virtual unordered_set<string> getFields() const { return {}; }
+
+  /**
+   * Optional runtime kill switch: a static boolean codelib field (same notation as getInstanceField()). If provided,
+   * every injected codelib call is skipped while the field is true, so instrumentation can be turned off without
+   * recompiling the app.
+   *
+   * @return the kill switch field or an empty string if injected calls are not guarded
+   */
+  virtual string getKillSwitch() const { return ""; }
+
+  /**
+   * Optional dispatcher that allows to coalesce several injections at the same site into a single codelib call.
+   * The dispatcher is a codelib method with a single `long` parameter, e.g.,
+   * `Lsaarland/cispa/artist/codelib/CodeLib;dispatch(J)V`, that invokes the i-th method of getDispatchedMethods() for
+   * each bit i set in its argument, in ascending order. Like all injected methods, it needs to be listed in
+   * getMethods().
+   *
+   * @return dispatcher signature or an empty string if injections are not coalesced
+   */
+  virtual string getDispatcher() const { return ""; }
+
+  /**
+   * The codelib methods that can be invoked through the dispatcher. Only methods without parameters can be
+   * dispatched, at most 64 of them.
+   *
+   * @return signatures of the dispatched methods, ordered by their bit in the dispatcher argument
+   */
+  virtual vector<string> getDispatchedMethods() const { return {}; }
 };  // class CodeLib
 
 }  // namespace art
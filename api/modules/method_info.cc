@@ -24,6 +24,8 @@
 #include "method_info.h"
 #include "utils.h"
 #include "optimizing/artist/api/utils/artist_utils.h"
+#include "optimizing/artist/api/io/error_handler.h"
+#include "optimizing/artist/internal/injection/injection_site_index.h"
 
 namespace art {
 
@@ -33,7 +35,8 @@ namespace art {
     : graph(methodGraph)
     , compilationUnit(compUnit)
     , methodName(PrettyMethod(graph->GetMethodIdx(), graph->GetDexFile(), false))
-    , methodNameWithSignature(PrettyMethod(graph->GetMethodIdx(), graph->GetDexFile(), true)) {
+    , methodNameWithSignature(PrettyMethod(graph->GetMethodIdx(), graph->GetDexFile(), true))
+    , injectionSites(nullptr) {
     // the other field will be set in the factory
   }
 
@@ -83,6 +86,28 @@ HGraph* MethodInfo::GetGraph() const {
   return graph;
 }
 
+const DexFile::CodeItem* MethodInfo::GetCodeItem() const {
+  return compilationUnit.GetCodeItem();
+}
+
+const InjectionSiteIndex& MethodInfo::GetInjectionSites() const {
+  // all passes of a method run on the same thread, so no synchronization is required
+  if (injectionSites == nullptr) {
+    injectionSites = new (graph->GetArena()) InjectionSiteIndex(graph);
+  }
+  return *injectionSites;
+}
+
+Handle<mirror::DexCache> MethodInfo::GetCodeLibDexCache(const CodeLibEnvironment& env) const {
+  // all handles are created up front (@see MethodInfoFactory::obtain), so no lock is required here
+  auto it = codelibDexCaches.find(&env);
+  if (it == codelibDexCaches.end()) {
+    ErrorHandler::abortCompilation("MethodInfo::GetCodeLibDexCache: no dex cache handle for the codelib of "
+                                   + methodName);
+  }
+  return it->second;
+}
+
 ostream &operator<<(ostream &os, const MethodInfo &info) {
   os << "MethodInfo { method: ";
   if (info.IsStatic()) {
@@ -23,18 +23,24 @@
 #ifndef ART_API_MODULES_METHOD_INFO_H_
 #define ART_API_MODULES_METHOD_INFO_H_
 
+#include <map>
 #include <string>
 #include <vector>
+#include "handle_scope.h"
 #include "optimizing/nodes.h"
 #include "driver/dex_compilation_unit.h"
 #include "optimizing/artist/api/utils/artist_utils.h"
 
+using std::map;
 using std::string;
 using std::vector;
 using std::shared_ptr;
 
 namespace art {
 
+class CodeLibEnvironment;
+class InjectionSiteIndex;
+
 /**
  * Wraps information about and convenience methods to work with the current method.
  */
@@ -46,6 +52,11 @@ class MethodInfo {
   const string& GetMethodName(bool signature = false) const;
   bool IsStatic() const;
   HGraph* GetGraph() const;
+  const DexFile::CodeItem* GetCodeItem() const;
+  // collected on first use and shared by all passes of this method
+  const InjectionSiteIndex& GetInjectionSites() const;
+  // created by MethodInfoFactory in the compiler's handle scope, so it stays valid as long as the method's instructions
+  Handle<mirror::DexCache> GetCodeLibDexCache(const CodeLibEnvironment& env) const;
 
   // parameters
   const vector<HParameterValue*>& GetParams() const;
@@ -60,6 +71,9 @@ class MethodInfo {
   const string methodNameWithSignature;
   vector<HParameterValue*> params;
   vector<string> paramTypes;
+  // arena-allocated, lazily initialized
+  mutable InjectionSiteIndex* injectionSites;
+  map<const CodeLibEnvironment*, Handle<mirror::DexCache>> codelibDexCaches;
 
   friend class MethodInfoFactory;
 };
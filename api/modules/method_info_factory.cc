@@ -22,13 +22,27 @@
 
 #include "method_info_factory.h"
 #include "optimizing/artist/internal/utils/param_finder.h"
+#include "module_manager.h"
 #include "dex_file-inl.h"
+#include "mirror/dex_cache.h"
+#include "thread-inl.h"
 
 namespace art {
 
-const MethodInfo MethodInfoFactory::obtain(HGraph *method_graph, const DexCompilationUnit &comp_unit) {
+const MethodInfo MethodInfoFactory::obtain(HGraph *method_graph, const DexCompilationUnit &comp_unit,
+                                           StackHandleScopeCollection *handles) {
   MethodInfo info(method_graph, comp_unit);
 
+  ModuleManager& module_manager = ModuleManager::getInstance();
+  if (handles != nullptr && module_manager.initialized()) {
+    Thread* self = Thread::Current();
+    Locks::mutator_lock_->AssertSharedHeld(self);
+    for (auto && it : module_manager.getCodelibEnvironments()) {
+      auto dex_cache = down_cast<mirror::DexCache*>(self->DecodeJObject(it.second->getDexCache()));
+      info.codelibDexCaches.emplace(it.second.get(), handles->NewHandle(dex_cache));
+    }
+  }
+
   string signature_string = method_graph->GetDexFile().GetMethodSignature(
       method_graph->GetDexFile().GetMethodId(method_graph->GetMethodIdx())).ToString();
 
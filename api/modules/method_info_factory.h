@@ -37,7 +37,15 @@ class MethodInfo;
  */
 class MethodInfoFactory {
  public:
-  static const MethodInfo obtain(HGraph *method_graph, const DexCompilationUnit &comp_unit);
+  /**
+   * Unless handles is nullptr, the caller needs to hold the mutator lock, e.g., the ScopedObjectAccess in which the
+   * compiler creates its handles for the method. The codelib dex caches are then added to these handles once, so that
+   * passes can inject codelib member accesses without taking the lock (@see MethodInfo::GetCodeLibDexCache).
+   *
+   * @param handles the compiler's handles for the method, nullptr if no codelib members will be accessed
+   */
+  static const MethodInfo obtain(HGraph *method_graph, const DexCompilationUnit &comp_unit,
+                                 StackHandleScopeCollection *handles);
 };
 
 }  // namespace art
@@ -39,4 +39,8 @@ bool Module::isEnabled() const {
 unique_ptr<Filter> Module::getMethodFilter() const {
   return nullptr;
 }
+
+shared_ptr<const FilesystemHelper> Module::getFilesystemHelper() const {
+  return _fs;
+}
 }  // namespace art
@@ -74,6 +74,13 @@ class Module {
    */
   virtual unique_ptr<Filter> getMethodFilter() const;
 
+  /**
+   * Return the filesystem helper of this module.
+   *
+   * @return filesystem helper or nullptr if fs access is not supported
+   */
+  shared_ptr<const FilesystemHelper> getFilesystemHelper() const;
+
  protected:
   // nullable: fs access is not always supported
   shared_ptr<const FilesystemHelper> _fs;
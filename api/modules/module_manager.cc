@@ -22,6 +22,9 @@
 #include "module_manager.h"
 #include "optimizing/artist/api/utils/artist_utils.h"
 #include "optimizing/artist/api/io/error_handler.h"
+#include "optimizing/artist/api/injection/fused_injection_artist.h"
+#include "optimizing/artist/internal/env/method_flags_table.h"
+#include "optimizing/artist/internal/utils/method_signature_cache.h"
 
 namespace art {
 
@@ -64,6 +67,11 @@ shared_ptr<CodeLibEnvironment> ModuleManager::getCodelibEnvironment(ModuleId id)
   return _environments.at(id);
 }
 
+const map<ModuleId, shared_ptr<CodeLibEnvironment>>& ModuleManager::getCodelibEnvironments() const {
+  CHECK(initialized());
+  return _environments;
+}
+
 const map<ModuleId, shared_ptr<Module>> ModuleManager::getModules() const {
   VLOG(artistd) << "ModuleManager: obtaining the modules map with " << _modules.size() << " entries.";
   return _modules;
@@ -78,34 +86,43 @@ void ModuleManager::initializeModules(vector<const DexFile*> dex_files, jobject
 
   _dex_file_env = make_shared<DexfileEnvironment>(dex_files);
 
-  for (auto it : _modules) {
-    auto id = it.first;
-    auto module = it.second;
-    auto codelib = module->createCodeLib();
+  // capture runtime data once so that compiler threads do not need to take the mutator lock to query it
+  MethodFlagsTable::Capture(dex_files);
+  MethodSignatureCache::Register(dex_files);
 
-    // initialize environment for codelib if present
+  // create all codelibs and look up their defining dex files with a single sweep over all class defs
+  vector<string> codelib_modules;
+  vector<shared_ptr<const CodeLib>> codelibs;
+  vector<string> codelib_classes;
+  for (auto it : _modules) {
+    auto codelib = it.second->createCodeLib();
     if (codelib != nullptr) {
-      VLOG(artistd) << "ModuleManager: initializing codelib environment for module " << id;
-
-      const MethodSignature signature = codelib->getCodeClass();
-      const DexFile* codelib_dexfile = nullptr;
-      for (auto && dexfile : dex_files) {
-        // check whether `dexfile` defines the code lib class (lookup by signature)
-        if (ArtUtils::FindClassDefIdxFromName(dexfile, signature)) {
-          codelib_dexfile = dexfile;
-          VLOG(artistd) << "ModuleManager: Found " << signature << " in dex file " << codelib_dexfile->GetLocation();
-          break;
-        }
-      }
-      if (codelib_dexfile == nullptr) {
-        auto msg = "Could not find dexfile defining codelib class " + signature
-                   + " (requires codelib). Deactivating module " + id + ".";
-        VLOG(artist) << msg;
-        module->setEnabled(false);
-      } else {
-        _dex_file_env->declareCodelib(codelib_dexfile);
-        _environments[id] = make_shared<CodeLibEnvironment>(_dex_file_env, codelib_dexfile, codelib, jclass_loader);
-      }
+      codelib_modules.push_back(it.first);
+      codelibs.push_back(codelib);
+      codelib_classes.push_back(codelib->getCodeClass());
+    }
+  }
+  auto codelib_dexfiles = ArtUtils::FindDefiningDexFiles(dex_files, codelib_classes);
+
+  // initialize environment for each codelib
+  for (size_t i = 0; i < codelibs.size(); i++) {
+    auto id = codelib_modules[i];
+    auto module = _modules.at(id);
+    auto codelib = codelibs[i];
+    const MethodSignature& signature = codelib_classes[i];
+    const DexFile* codelib_dexfile = codelib_dexfiles[i];
+    VLOG(artistd) << "ModuleManager: initializing codelib environment for module " << id;
+
+    if (codelib_dexfile == nullptr) {
+      auto msg = "Could not find dexfile defining codelib class " + signature
+                 + " (requires codelib). Deactivating module " + id + ".";
+      VLOG(artist) << msg;
+      module->setEnabled(false);
+    } else {
+      VLOG(artistd) << "ModuleManager: Found " << signature << " in dex file " << codelib_dexfile->GetLocation();
+      _dex_file_env->declareCodelib(codelib_dexfile);
+      _environments[id] = make_shared<CodeLibEnvironment>(_dex_file_env, codelib_dexfile, codelib, jclass_loader,
+                                                          module->getFilesystemHelper());
     }
   }
 
@@ -113,6 +130,55 @@ void ModuleManager::initializeModules(vector<const DexFile*> dex_files, jobject
   _init_flag = true;
 }
 
+vector<HArtist*> ModuleManager::createPasses(const MethodInfo& method_info) const {
+  CHECK(initialized());
+  vector<HArtist*> passes;
+  // consecutive injection passes that are not yet added to passes
+  vector<HInjectionArtist*> injection_passes;
+  size_t injection_pass_count = 0;
+  // only adjacent injection passes are fused, so all passes still run in module order
+  auto flush_injection_passes = [this, &method_info, &passes, &injection_passes]() {
+    if (injection_passes.size() == 1) {
+      passes.push_back(injection_passes.front());
+    } else if (injection_passes.size() > 1) {
+      HArtist* fused = new (method_info.GetGraph()->GetArena()) HFusedInjectionArtist(method_info, injection_passes);
+      fused->setDexfileEnvironment(_dex_file_env);
+      passes.push_back(fused);
+    }
+    injection_passes.clear();
+  };
+  for (auto it : _modules) {
+    auto module = it.second;
+    if (!module->isEnabled()) {
+      continue;
+    }
+    auto filter = module->getMethodFilter();
+    if (filter != nullptr && !filter->accept(method_info)) {
+      continue;
+    }
+    HArtist* pass = module->createPass(method_info);
+    pass->setDexfileEnvironment(_dex_file_env);
+    auto env = _environments.find(it.first);
+    if (env != _environments.end()) {
+      pass->setCodeLibEnvironment(env->second);
+    }
+
+    auto injection_pass = pass->AsInjectionArtist();
+    if (injection_pass != nullptr && env != _environments.end()) {
+      injection_passes.push_back(injection_pass);
+      injection_pass_count++;
+    } else {
+      flush_injection_passes();
+      passes.push_back(pass);
+    }
+  }
+  flush_injection_passes();
+
+  VLOG(artistd) << "ModuleManager: created " << passes.size() << " passes (" << injection_pass_count
+                << " injection passes)";
+  return passes;
+}
+
   bool ModuleManager::initialized() const {
       return _init_flag;
   }
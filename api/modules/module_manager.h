@@ -68,10 +68,26 @@ class ModuleManager {
     shared_ptr<Module> getModule(ModuleId id) const;
     shared_ptr<const DexfileEnvironment> getDexFileEnvironment() const;
     shared_ptr<CodeLibEnvironment> getCodelibEnvironment(ModuleId id) const;
+    // only modules with a codelib have an environment
+    const map<ModuleId, shared_ptr<CodeLibEnvironment>>& getCodelibEnvironments() const;
 
     const map<ModuleId, shared_ptr<Module>> getModules() const;
 
     void initializeModules(vector<const DexFile*> dex_files, jobject jclass_loader);
+
+    /**
+     * Creates the passes of all enabled modules that accept the given method, with their environments already set.
+     * Injection passes (@see HInjectionArtist) of adjacent modules are fused into a single pass that visits the
+     * method's injection sites only once (@see HFusedInjectionArtist). A pass of any other kind in between ends
+     * the fused group, so all passes still run in module order.
+     *
+     * This is the only supported way to create passes. The compiler hook (outside of this repository, see README)
+     * needs to call it instead of Module::createPass, otherwise passes lack their environments and are not fused.
+     *
+     * @param method_info the method to be compiled
+     * @return the passes to be run, in module order
+     */
+    vector<HArtist*> createPasses(const MethodInfo& method_info) const;
     bool initialized() const;
 
  private:
@@ -27,7 +27,11 @@
 #include "optimizing/artist/api/env/java_env.h"
 #include "mirror/dex_cache-inl.h"
 #include "optimizing/artist/internal/utils/param_finder.h"
+#include "optimizing/artist/internal/env/method_flags_table.h"
+#include "optimizing/artist/internal/utils/dex_symbol_index.h"
+#include "optimizing/artist/internal/utils/method_signature_cache.h"
 #include "optimizing/artist/api/io/error_handler.h"
+#include "optimizing/artist/api/modules/method_info.h"
 
 #include "optimizing/artist/api/injection/primitives.h"
 #include "optimizing/artist/api/injection/boolean.h"
@@ -41,103 +45,113 @@
 #include "driver/compiler_driver-inl.h"
 
 using std::static_pointer_cast;
+using std::unordered_map;
 
 namespace art {
 
 const DexFile::MethodId* ArtUtils::FindMethodId(const DexFile* dex_file,
                                                 const string& searched_method_name) {
-  const size_t methodCount = dex_file->NumMethodIds();
-
-  const DexFile::MethodId* foundMethodId = nullptr;
-
-  for (uint32_t i = 0; i< methodCount; i++) {
-    const DexFile::MethodId& methodId = dex_file->GetMethodId(i);
-    const string methodClass = dex_file->GetMethodDeclaringClassDescriptor(methodId);
-    const string methodName = dex_file->GetMethodName(methodId);
-    const string methodSignature = dex_file->GetMethodSignature(methodId).ToString();
-    const string fullyQualifiedMethodName(methodClass + methodName + methodSignature);
-
-    if (searched_method_name.compare(fullyQualifiedMethodName) == 0) {
-      foundMethodId = &methodId;
-      break;
-    }
-  }
-  if (foundMethodId == nullptr) {
+  MethodIdx method_idx;
+  if (!DexSymbolIndex::Get(dex_file)->FindMethodIdx(searched_method_name, &method_idx)) {
     VLOG(artistd) << "NOT FOUND: " << searched_method_name;
+    return nullptr;
   }
-  return foundMethodId;
+  return &dex_file->GetMethodId(method_idx);
 }
 
 bool ArtUtils::FindMethodIdx(const DexFile* dex_file, const string& searched_method_name, MethodIdx* result = nullptr) {
-  const DexFile::MethodId* methodId = ArtUtils::FindMethodId(dex_file, searched_method_name);
-  if (methodId != nullptr) {
-    if (result) {
-      *result = dex_file->GetIndexForMethodId(*methodId);
-    }
+  if (DexSymbolIndex::Get(dex_file)->FindMethodIdx(searched_method_name, result)) {
     return true;
   }
+  VLOG(artistd) << "NOT FOUND: " << searched_method_name;
   return false;
 }
 
-bool ArtUtils::FindTypeIdxFromName(const DexFile* dex_file, const string & searched_type_name,
-                                   TypeIdx* result = nullptr) {
-  for (uint32_t i = 0; i < dex_file->NumTypeIds(); i++) {
-    const DexFile::TypeId& typeId = dex_file->GetTypeId(i);
-    string type_name(dex_file->GetTypeDescriptor(typeId));
-    if (type_name.compare(searched_type_name) == 0) {
-      TypeIdx typeIdx = dex_file->GetIndexForTypeId(typeId);
-      VLOG(artistd) << "Returning TypeIdx: " << typeIdx << " Type: " << searched_type_name;
-      if (result) {
-        *result = typeIdx;
+bool ArtUtils::FindMethodIdxs(const DexFile* dex_file, const unordered_set<string>& signatures,
+                              map<MethodSignature, MethodIdx>* result, vector<MethodSignature>* missing) {
+  CHECK(result != nullptr);
+  auto index = DexSymbolIndex::Get(dex_file);
+  bool found_all = true;
+  for (auto && signature : signatures) {
+    MethodIdx method_idx;
+    if (index->FindMethodIdx(signature, &method_idx)) {
+      (*result)[signature] = method_idx;
+    } else {
+      VLOG(artistd) << "NOT FOUND: " << signature;
+      found_all = false;
+      if (missing) {
+        missing->push_back(signature);
       }
-      return true;
     }
   }
-  return false;
+  return found_all;
+}
+
+bool ArtUtils::FindTypeIdxFromName(const DexFile* dex_file, const string & searched_type_name,
+                                   TypeIdx* result = nullptr) {
+  TypeIdx typeIdx;
+  if (!DexSymbolIndex::Get(dex_file)->FindTypeIdx(searched_type_name, &typeIdx)) {
+    return false;
+  }
+  VLOG(artistd) << "Returning TypeIdx: " << typeIdx << " Type: " << searched_type_name;
+  if (result) {
+    *result = typeIdx;
+  }
+  return true;
 }
 
 bool ArtUtils::FindFieldIdxFromName(const DexFile* dex_file, const string & searched_field_type,
                                     FieldIdx* result = nullptr) {
-  for (uint32_t i = 0; i < dex_file->NumFieldIds(); i++) {
-    const DexFile::FieldId &fieldId = dex_file->GetFieldId(i);
-
-    const string fieldName(dex_file->GetFieldName(fieldId));
-    const string fieldType(dex_file->GetFieldTypeDescriptor(fieldId));
-    const string fullyQualifiedFieldName(fieldType + fieldName);
-
-    if (fullyQualifiedFieldName.compare(searched_field_type) == 0) {
-      FieldIdx fieldIdx = dex_file->GetIndexForFieldId(fieldId);
-      VLOG(artistd) << "Found FieldIdx: " << fieldIdx << " for field type " << searched_field_type;
-      if (result) {
-        *result = fieldIdx;
-      }
-      return true;
-    }
+  FieldIdx fieldIdx;
+  if (!DexSymbolIndex::Get(dex_file)->FindFieldIdx(searched_field_type, &fieldIdx)) {
+    return false;
   }
-  return false;
+  VLOG(artistd) << "Found FieldIdx: " << fieldIdx << " for field type " << searched_field_type;
+  if (result) {
+    *result = fieldIdx;
+  }
+  return true;
 }
 
 bool ArtUtils::FindClassDefIdxFromName(const DexFile* dex_file, const  string & searched_signature,
                                        ClassDefIdx* result) {
   VLOG(artistd) << "Check whether " << dex_file->GetLocation() << " defines " << searched_signature;
-  for (uint16_t idx = 0; idx < dex_file->NumClassDefs(); idx++) {
-    auto class_def = &dex_file->GetClassDef(idx);
-    ClassDefIdx class_idx = class_def->class_idx_;
-    auto candidate_signature = dex_file->StringByTypeIdx(class_idx);
-    VLOG(artistd) << "Comparing candidate " << candidate_signature << " to searched " << searched_signature;
-    // search for perfect match
-    if (searched_signature.find(candidate_signature) == 0) {
-      VLOG(artistd) << "Signature found.";
-      if (result) {
-        *result = idx;
-      }
-      return true;
-    }
+  if (DexSymbolIndex::Get(dex_file)->FindClassDefIdx(searched_signature, result)) {
+    VLOG(artistd) << "Signature found.";
+    return true;
   }
   VLOG(artistd) << "Could not find signature " << searched_signature;
   return false;
 }
 
+vector<const DexFile*> ArtUtils::FindDefiningDexFiles(const vector<const DexFile*>& dex_files,
+                                                      const vector<string>& class_signatures) {
+  vector<const DexFile*> result(class_signatures.size(), nullptr);
+  unordered_map<StringPiece, vector<size_t>, StringPieceHash> searched;
+  for (size_t i = 0; i < class_signatures.size(); i++) {
+    searched[class_signatures[i]].push_back(i);
+  }
+
+  for (auto && dex_file : dex_files) {
+    if (searched.empty()) {
+      break;
+    }
+    for (uint32_t idx = 0; idx < dex_file->NumClassDefs(); idx++) {
+      const DexFile::ClassDef& class_def = dex_file->GetClassDef(idx);
+      auto found = searched.find(StringPiece(dex_file->StringByTypeIdx(class_def.class_idx_)));
+      if (found == searched.end()) {
+        continue;
+      }
+      VLOG(artistd) << "Found " << found->first << " in dex file " << dex_file->GetLocation();
+      for (auto && position : found->second) {
+        result[position] = dex_file;
+      }
+      // first definition wins
+      searched.erase(found);
+    }
+  }
+  return result;
+}
 
 void ArtUtils::DumpTypes(const DexFile& dex_file) {
   VLOG(artistd) << "DumpTypes()";
@@ -167,16 +181,21 @@ void ArtUtils::DumpFields(const DexFile& dex_file) {
  *  Subsequent calls use the already injected and initialized CodeLib.
  *
  * @param instruction_cursor cursor where the codelib should get injected
+ * @param method_info the method under compilation, provides the handle scope for the codelib's dex cache
  * @param entry_block_injection true|false Injetc in Entry Block of the graph or tight before the instruction_cursor
  *                              if false is selected.
  *
  */
 HInstruction* ArtUtils::InjectCodeLib(const HInstruction* instruction_cursor,
                                       shared_ptr<CodeLibEnvironment> env,
+                                      const MethodInfo& method_info,
                                       const bool entry_block_injection) {
   CHECK(instruction_cursor != nullptr);
   CHECK(env != nullptr);
   VLOG(artistd) << "ArtUtils::InjectCodeLib()" << std::flush;
+  if (env->usesStaticMethods()) {
+    ErrorHandler::abortCompilation("ArtUtils::InjectCodeLib: static codelib methods are called without an instance");
+  }
   HGraph* graph = instruction_cursor->GetBlock()->GetGraph();
   VLOG(artistd) << "ArtUtils::InjectCodeLib() Dex: " << graph->GetDexFile().GetLocation() << std::flush;
   ArenaAllocator* allocator = graph->GetArena();
@@ -188,37 +207,11 @@ HInstruction* ArtUtils::InjectCodeLib(const HInstruction* instruction_cursor,
     injection_cursor = const_cast<HInstruction*>(instruction_cursor);
   }
 
-  auto symbols = env->getCodelibSymbols(&graph->GetDexFile());
-
   HBasicBlock* injectionBlock = injection_cursor->GetBlock();
 
   CHECK(injectionBlock != nullptr);
 
-#ifdef BUILD_MARSHMALLOW
-
-  HLoadClass* loadClassCodeLib = new(allocator) HLoadClass(
-  symbols->getTypeIdx()
-  , false
-  , 0);
-
-#else
-  HLoadClass* loadClassCodeLib = new(allocator) HLoadClass(
-      graph->GetCurrentMethod(),
-      symbols->getTypeIdx(),
-      graph->GetDexFile(),
-      false,
-      0,
-      true,    // seems to have no influence, but we also add a manual CLinitcheck in both cases.
-      false);  // must be false, crashes otherwise
-
-#endif
-
-  injectionBlock->InsertInstructionBefore(loadClassCodeLib, injection_cursor);
-
-
-
-  HClinitCheck* clInitCheckCodelib = new(allocator) HClinitCheck(loadClassCodeLib, 0);
-  injectionBlock->InsertInstructionAfter(clInitCheckCodelib, loadClassCodeLib);
+  HInstruction* clInitCheckCodelib = InjectCodeLibClass(injection_cursor, env);
   HInstruction* return_cursor = clInitCheckCodelib;
 
   const bool IS_VOLATILE = false;
@@ -229,19 +222,9 @@ HInstruction* ArtUtils::InjectCodeLib(const HInstruction* instruction_cursor,
                                                                        field_offset,
                                                                        IS_VOLATILE);
 #else
-  // Getting the dexCache;
-  // ScopedObjectAccess includes locking the mutator lock
+  // the handle is created along with the method info, so no runtime lock is required here
   const DexFile& codelib_dexfile(*env->getDexFile());
-  ScopedObjectAccess soa(Thread::Current());
-  StackHandleScope<1> hs(soa.Self());
-  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
-
-
-  Handle<mirror::DexCache> codelib_dex_cache(
-          hs.NewHandle(
-                  class_linker->FindDexCache(
-                          Thread::Current(), codelib_dexfile, false)));
-
+  Handle<mirror::DexCache> codelib_dex_cache(method_info.GetCodeLibDexCache(*env));
 
   FieldIdx field_idx = env->getInstanceFieldIdx();
   HStaticFieldGet* getFieldInstance = new(allocator) HStaticFieldGet(clInitCheckCodelib,
@@ -266,17 +249,339 @@ HInstruction* ArtUtils::InjectCodeLib(const HInstruction* instruction_cursor,
   return return_cursor;
 }
 
+/**
+ * Loads and initializes the codelib class right before the instruction_cursor.
+ *
+ * @return the initialized class, to be used as input for static codelib field accesses
+ */
+HInstruction* ArtUtils::InjectCodeLibClass(HInstruction* instruction_cursor, shared_ptr<CodeLibEnvironment> env) {
+  CHECK(instruction_cursor != nullptr);
+  CHECK(env != nullptr);
+  HBasicBlock* injectionBlock = instruction_cursor->GetBlock();
+  HGraph* graph = injectionBlock->GetGraph();
+  ArenaAllocator* allocator = graph->GetArena();
+  auto symbols = env->getCodelibSymbols(&graph->GetDexFile());
+
+#ifdef BUILD_MARSHMALLOW
+
+  HLoadClass* loadClassCodeLib = new(allocator) HLoadClass(
+  symbols->getTypeIdx()
+  , false
+  , 0);
+
+#else
+  HLoadClass* loadClassCodeLib = new(allocator) HLoadClass(
+      graph->GetCurrentMethod(),
+      symbols->getTypeIdx(),
+      graph->GetDexFile(),
+      false,
+      0,
+      true,    // seems to have no influence, but we also add a manual CLinitcheck in both cases.
+      false);  // must be false, crashes otherwise
+
+#endif
+
+  injectionBlock->InsertInstructionBefore(loadClassCodeLib, instruction_cursor);
+
+  HClinitCheck* clInitCheckCodelib = new(allocator) HClinitCheck(loadClassCodeLib, 0);
+  injectionBlock->InsertInstructionAfter(clInitCheckCodelib, loadClassCodeLib);
+  return clInitCheckCodelib;
+}
+
+/**
+ * Reads a static codelib field (@see CodeLib::getFields) right before the instruction_cursor.
+ *
+ * @param codelib_class the initialized codelib class (@see InjectCodeLibClass)
+ */
+HInstruction* ArtUtils::InjectStaticFieldGet(HInstruction* instruction_cursor,
+                                             HInstruction* codelib_class,
+                                             const CodelibField& field,
+                                             shared_ptr<CodeLibEnvironment> env,
+                                             const MethodInfo& method_info) {
+  CHECK(instruction_cursor != nullptr);
+  ArenaAllocator* allocator = instruction_cursor->GetBlock()->GetGraph()->GetArena();
+#ifdef BUILD_MARSHMALLOW
+  HStaticFieldGet* fieldGet = new(allocator) HStaticFieldGet(codelib_class,
+                                                             field.type,
+                                                             field.offset,
+                                                             field.is_volatile);
+#else
+  HStaticFieldGet* fieldGet = new(allocator) HStaticFieldGet(codelib_class,
+                                                             field.type,
+                                                             field.offset,
+                                                             field.is_volatile,
+                                                             field.field_idx,
+                                                             env->getClassDefIdx(),
+                                                             *env->getDexFile(),
+                                                             method_info.GetCodeLibDexCache(*env),
+                                                             0);
+#endif
+  instruction_cursor->GetBlock()->InsertInstructionBefore(fieldGet, instruction_cursor);
+  return fieldGet;
+}
+
+/**
+ * Writes a static codelib field (@see CodeLib::getFields) right before the instruction_cursor.
+ *
+ * @param codelib_class the initialized codelib class (@see InjectCodeLibClass)
+ */
+HInstruction* ArtUtils::InjectStaticFieldSet(HInstruction* instruction_cursor,
+                                             HInstruction* codelib_class,
+                                             const CodelibField& field,
+                                             HInstruction* value,
+                                             shared_ptr<CodeLibEnvironment> env,
+                                             const MethodInfo& method_info) {
+  CHECK(instruction_cursor != nullptr);
+  ArenaAllocator* allocator = instruction_cursor->GetBlock()->GetGraph()->GetArena();
+#ifdef BUILD_MARSHMALLOW
+  HStaticFieldSet* fieldSet = new(allocator) HStaticFieldSet(codelib_class,
+                                                             value,
+                                                             field.type,
+                                                             field.offset,
+                                                             field.is_volatile);
+#else
+  HStaticFieldSet* fieldSet = new(allocator) HStaticFieldSet(codelib_class,
+                                                             value,
+                                                             field.type,
+                                                             field.offset,
+                                                             field.is_volatile,
+                                                             field.field_idx,
+                                                             env->getClassDefIdx(),
+                                                             *env->getDexFile(),
+                                                             method_info.GetCodeLibDexCache(*env),
+                                                             0);
+#endif
+  instruction_cursor->GetBlock()->InsertInstructionBefore(fieldSet, instruction_cursor);
+  return fieldSet;
+}
+
+/**
+ * Splits the block of instruction_cursor right in front of it and branches on the given condition, which needs to be
+ * the instruction directly before the cursor. The guarded code gets its own block, whose last instruction is returned
+ * as the cursor to insert the guarded code before; the other path only has an empty block to avoid critical edges.
+ * Loop and try membership of the new blocks is inherited from the split block, while the dominator tree is recomputed.
+ * If the split block is a catch block, only its entry stays one, so the new blocks are in neither a try nor a catch.
+ *
+ * @param guarded_if_true whether the guarded block is entered if the condition is true or if it is false
+ * @return the cursor in the guarded block
+ */
+HInstruction* ArtUtils::InjectConditionalBlock(HInstruction* instruction_cursor,
+                                               HInstruction* condition,
+                                               bool guarded_if_true) {
+  CHECK(instruction_cursor != nullptr);
+  CHECK_EQ(condition->GetNext(), instruction_cursor);
+  HBasicBlock* block = instruction_cursor->GetBlock();
+  HGraph* graph = block->GetGraph();
+  ArenaAllocator* allocator = graph->GetArena();
+
+  // the cursor and everything after it moves to the join block, which takes over the successors
+#ifdef BUILD_MARSHMALLOW
+  HBasicBlock* join = block->SplitAfter(condition);
+#else
+  HBasicBlock* join = block->SplitAfterForInlining(condition);
+#endif
+  HBasicBlock* guarded = new (allocator) HBasicBlock(graph, instruction_cursor->GetDexPc());
+  HBasicBlock* skipped = new (allocator) HBasicBlock(graph, instruction_cursor->GetDexPc());
+  graph->AddBlock(join);
+  graph->AddBlock(guarded);
+  graph->AddBlock(skipped);
+
+  block->AddInstruction(new (allocator) HIf(condition));
+  // the true successor comes first
+  block->AddSuccessor(guarded_if_true ? guarded : skipped);
+  block->AddSuccessor(guarded_if_true ? skipped : guarded);
+  guarded->AddInstruction(new (allocator) HGoto());
+  guarded->AddSuccessor(join);
+  skipped->AddInstruction(new (allocator) HGoto());
+  skipped->AddSuccessor(join);
+
+  HLoopInformation* loop_info = block->GetLoopInformation();
+#ifndef BUILD_MARSHMALLOW
+  // like the inliner, only try membership is propagated: catch information marks the handler's entry block and catch
+  // blocks are never in a try, so the code after a catch block's entry needs none
+  TryCatchInformation* try_info = block->IsTryBlock() ? block->GetTryCatchInformation() : nullptr;
+#endif
+  if (loop_info != nullptr && loop_info->IsBackEdge(*block)) {
+    loop_info->ReplaceBackEdge(block, join);
+  }
+  for (HBasicBlock* added : { join, guarded, skipped }) {
+    if (loop_info != nullptr) {
+      added->SetLoopInformation(loop_info);
+      for (HLoopInformationOutwardIterator it(*block); !it.Done(); it.Advance()) {
+        it.Current()->Add(added);
+      }
+    }
+#ifndef BUILD_MARSHMALLOW
+    if (try_info != nullptr) {
+      added->SetTryCatchInformation(try_info);
+    }
+#endif
+  }
+  graph->ClearDominanceInformation();
+  // the new blocks are not in the old reverse post order, and join took over the dominated blocks of the split block
+  for (HBasicBlock* added : { join, guarded, skipped }) {
+    added->ClearDominanceInformation();
+  }
+  graph->ComputeDominanceInformation();
+
+  return guarded->GetLastInstruction();
+}
+
+/**
+ * Guards code by a countdown on a static int codelib field, so that it is only executed once every `rate` times:
+ *
+ *   counter = counter - 1
+ *   if (counter <= 0) { counter = rate; <guarded code> }
+ *   instruction_cursor
+ *
+ * The skipped path only costs the field update and the compare.
+ *
+ * @return the cursor to insert the guarded code before
+ */
+HInstruction* ArtUtils::InjectCountdownGuard(HInstruction* instruction_cursor,
+                                             const CodelibField& counter,
+                                             uint32_t rate,
+                                             shared_ptr<CodeLibEnvironment> env,
+                                             const MethodInfo& method_info) {
+  CHECK(instruction_cursor != nullptr);
+  if (counter.type != Primitive::kPrimInt) {
+    ErrorHandler::abortCompilation("ArtUtils::InjectCountdownGuard: the sampling counter needs to be an int field");
+  }
+  HBasicBlock* block = instruction_cursor->GetBlock();
+  HGraph* graph = block->GetGraph();
+  ArenaAllocator* allocator = graph->GetArena();
+
+  HInstruction* codelib_class = InjectCodeLibClass(instruction_cursor, env);
+  HInstruction* count = InjectStaticFieldGet(instruction_cursor, codelib_class, counter, env, method_info);
+  HSub* remaining = new (allocator) HSub(Primitive::kPrimInt, count, graph->GetIntConstant(1));
+  block->InsertInstructionBefore(remaining, instruction_cursor);
+  InjectStaticFieldSet(instruction_cursor, codelib_class, counter, remaining, env, method_info);
+  HLessThanOrEqual* expired = new (allocator) HLessThanOrEqual(remaining, graph->GetIntConstant(0));
+  block->InsertInstructionBefore(expired, instruction_cursor);
+
+  HInstruction* guarded_cursor = InjectConditionalBlock(instruction_cursor, expired, true);
+  InjectStaticFieldSet(guarded_cursor, codelib_class, counter, graph->GetIntConstant(rate), env, method_info);
+  return guarded_cursor;
+}
+
+/**
+ * Guards code by the codelib's kill switch (@see CodeLib::getKillSwitch): the guarded code is skipped as long as the
+ * static boolean is set. The flag itself is the branch condition, so the check is a single field load and a
+ * branch on zero. The (non-volatile) loads of several guards are subject to GVN and LICM like any other field load.
+ *
+ * @return the cursor to insert the guarded code before
+ */
+HInstruction* ArtUtils::InjectKillSwitchGuard(HInstruction* instruction_cursor,
+                                              shared_ptr<CodeLibEnvironment> env,
+                                              const MethodInfo& method_info) {
+  CHECK(instruction_cursor != nullptr);
+  CHECK(env->hasKillSwitch());
+  HInstruction* codelib_class = InjectCodeLibClass(instruction_cursor, env);
+  HInstruction* disabled = InjectStaticFieldGet(instruction_cursor, codelib_class, env->getKillSwitch(), env,
+                                                method_info);
+  return InjectConditionalBlock(instruction_cursor, disabled, false);
+}
+
+/**
+ * Moves the codelib instance load (as created by InjectCodeLib in the entry block) down to the nearest common
+ * dominator of its users, right before the first user in that block. So the load is only executed on paths that
+ * actually reach an injection site.
+ *
+ * The load is never moved into a loop, it is placed in the pre-header of the outermost loop instead. It is not moved
+ * into try or catch blocks either, since it might throw; the nearest dominator outside of them is chosen. If the users
+ * cannot be analyzed (phis or environment uses), the load stays in the entry block.
+ */
+void ArtUtils::SinkCodeLib(HInstruction* codelib_instruction) {
+  CHECK(codelib_instruction != nullptr);
+  HBasicBlock* entry_block = codelib_instruction->GetBlock()->GetGraph()->GetEntryBlock();
+  if (codelib_instruction->GetBlock() != entry_block || codelib_instruction->HasEnvironmentUses()) {
+    return;
+  }
+
+  HBasicBlock* dominator = nullptr;
+  for (HUseIterator<HInstruction*> it(codelib_instruction->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user->IsPhi()) {
+      return;
+    }
+    HBasicBlock* block = user->GetBlock();
+    if (dominator == nullptr) {
+      dominator = block;
+    } else {
+      while (!dominator->Dominates(block)) {
+        dominator = dominator->GetDominator();
+      }
+    }
+  }
+  if (dominator == nullptr) {
+    return;
+  }
+
+  bool moved;
+  do {
+    moved = false;
+    if (dominator->GetLoopInformation() != nullptr) {
+      dominator = dominator->GetLoopInformation()->GetPreHeader();
+      moved = true;
+    }
+#ifndef BUILD_MARSHMALLOW
+    if (dominator->IsInTry() || dominator->IsCatchBlock()) {
+      dominator = dominator->GetDominator();
+      moved = true;
+    }
+#endif
+  } while (moved);
+  if (dominator == entry_block) {
+    return;
+  }
+
+  HInstruction* cursor = dominator->GetLastInstruction();
+  for (HUseIterator<HInstruction*> it(codelib_instruction->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user->GetBlock() == dominator && user->StrictlyDominates(cursor)) {
+      cursor = user;
+    }
+  }
+
+  // the load is a chain from HLoadClass down to the instance, which is moved as a whole, preserving its order
+  vector<HInstruction*> chain;
+  for (HInstruction* current = codelib_instruction; ; current = current->InputAt(0)) {
+    chain.push_back(current);
+    if (current->IsLoadClass()) {
+      break;
+    }
+  }
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+    (*it)->MoveBefore(cursor);
+  }
+  VLOG(artistd) << "ArtUtils::SinkCodeLib() moved codelib load to block " << dominator->GetBlockId();
+}
+
 HInstruction* ArtUtils::InjectMethodCall(HInstruction* instruction_cursor,
                                 const string& method_signature,
                                 vector<HInstruction*>& function_params,
                                 shared_ptr<CodeLibEnvironment> env,
                                 const Primitive::Type return_type,
                                 const bool inject_before) {
+  SignatureId signature_id;
+  if (!SignatureInterner::getInstance().lookup(method_signature, &signature_id)) {
+    auto msg("ArtUtils::InjectMethodCall: unknown codelib method " + method_signature);
+    ErrorHandler::abortCompilation(msg);
+  }
+  return InjectMethodCall(instruction_cursor, signature_id, function_params, env, return_type, inject_before);
+}
+
+HInstruction* ArtUtils::InjectMethodCall(HInstruction* instruction_cursor,
+                                SignatureId method_signature,
+                                vector<HInstruction*>& function_params,
+                                shared_ptr<CodeLibEnvironment> env,
+                                const Primitive::Type return_type,
+                                const bool inject_before) {
   CHECK(env != nullptr);
   VLOG(artistd) << "ArtUtils::InjectMethodCall() Params : "
                << function_params.size()
                << " - "
-               << method_signature;
+               << SignatureInterner::getInstance().resolve(method_signature);
   VLOG(artistd) << "ArtUtils::InjectMethodCall() instruction: " << instruction_cursor << std::flush;
   VLOG(artistd) << "ArtUtils::InjectMethodCall() block:       " << instruction_cursor->GetBlock() << std::flush;
   HGraph* graph = instruction_cursor->GetBlock()->GetGraph();
@@ -295,13 +600,32 @@ HInstruction* ArtUtils::InjectMethodCall(HInstruction* instruction_cursor,
   auto symbols = env->getCodelibSymbols(&current);
   const uint32_t DEX_PC = 0;
 
-  // VTableIndex
-  HInvokeVirtual* invokeInstruction = new (allocator) HInvokeVirtual(allocator,
-                                                                     (uint32_t) function_params.size(),
-                                                                     return_type,
-                                                                     DEX_PC,
-                                                                     symbols->getMethodIdx(method_signature),
-                                                                     (uint32_t) env->getMethodVtableIdx(method_signature));
+  HInvoke* invokeInstruction;
+  if (env->usesStaticMethods()) {
+#ifdef BUILD_MARSHMALLOW
+    // rejected when the environment is created (@see CodeLibEnvironment::resolveRuntimeSymbols)
+    UNREACHABLE();
+#else
+    // An HInvokeStaticOrDirect would load its target from the caller's dex cache and, as long as that entry is not
+    // resolved, rely on the resolution trampoline, which decodes the invoke at the call's dex pc. Injected calls have
+    // no such invoke in the caller's code, so the call goes through the static invoke trampoline instead, which
+    // resolves the method by its index in the caller's dex file. The codelib class is initialized explicitly below.
+    invokeInstruction = new (allocator) HInvokeUnresolved(allocator,
+                                                          (uint32_t) function_params.size(),
+                                                          return_type,
+                                                          DEX_PC,
+                                                          symbols->getMethodIdx(method_signature),
+                                                          kStatic);
+#endif
+  } else {
+    // VTableIndex
+    invokeInstruction = new (allocator) HInvokeVirtual(allocator,
+                                                       (uint32_t) function_params.size(),
+                                                       return_type,
+                                                       DEX_PC,
+                                                       symbols->getMethodIdx(method_signature),
+                                                       (uint32_t) env->getMethodVtableIdx(method_signature));
+  }
 
   ArtUtils::SetupInstructionArguments(invokeInstruction, function_params);
 
@@ -311,8 +635,12 @@ HInstruction* ArtUtils::InjectMethodCall(HInstruction* instruction_cursor,
   } else {
     instructionBlock->InsertInstructionAfter(invokeInstruction, instruction_cursor);
   }
+  if (env->usesStaticMethods()) {
+    InjectCodeLibClass(invokeInstruction, env);
+  }
+  ArtUtils::UpdateMaximumNumberOfOutVRegs(graph, invokeInstruction);
   VLOG(artistd) << "ArtUtils::InjectMethodCall: " << invokeInstruction;
-  VLOG(artistd) << "ArtUtils::InjectMethodCall SUCCESS: " << method_signature;
+  VLOG(artistd) << "ArtUtils::InjectMethodCall SUCCESS: " << SignatureInterner::getInstance().resolve(method_signature);
 
   return invokeInstruction;
 }
@@ -321,18 +649,27 @@ string ArtUtils::GetMethodName(HInvoke* invoke, bool signature) {
   return PrettyMethod(invoke->GetDexMethodIndex(), invoke->GetBlock()->GetGraph()->GetDexFile(), signature);
 }
 
-string ArtUtils::GetMethodSignature(const HInvoke* invoke) {
-  const DexFile& dexfile = invoke->GetBlock()->GetGraph()->GetDexFile();
-  auto method_idx = invoke->GetDexMethodIndex();
-  const DexFile::MethodId& method_id = dexfile.GetMethodId(method_idx);
-
-  const string method_class = dexfile.GetMethodDeclaringClassDescriptor(method_id);
-  const string method_name = dexfile.GetMethodName(method_id);
-  const string method_signature = dexfile.GetMethodSignature(method_id).ToString();
+/**
+ * Accounts for an injected invoke in the graph's maximum number of out vregs. Needs to be called for each invoke that
+ * is added to a graph, since the maximum is not recomputed after ARTist passes (@see HArtist::Run).
+ */
+void ArtUtils::UpdateMaximumNumberOfOutVRegs(HGraph* graph, HInvoke* invoke) {
+  auto args = static_cast<uint16_t>(invoke->GetNumberOfArguments());
+  if (args > graph->GetMaximumNumberOfOutVRegs()) {
+    graph->SetMaximumNumberOfOutVRegs(args);
+  }
+}
 
-  const string fully_qualified_method_name = (method_class + method_name + method_signature);
+const string& ArtUtils::GetMethodSignature(const HInvoke* invoke) {
+  return GetMethodSignature(invoke->GetBlock()->GetGraph()->GetDexFile(), invoke->GetDexMethodIndex());
+}
 
-  return fully_qualified_method_name;
+/**
+ * Provides the fully qualified signature (class descriptor + name + prototype) of a method id.
+ * Signatures are memoized per dex file, so the returned reference stays valid for the whole compilation.
+ */
+const string& ArtUtils::GetMethodSignature(const DexFile& dexfile, MethodIdx method_idx) {
+  return MethodSignatureCache::Get(dexfile, method_idx);
 }
 
 string ArtUtils::GetDexFileName(const HGraph* graph) {
@@ -341,9 +678,16 @@ string ArtUtils::GetDexFileName(const HGraph* graph) {
 }
 
 bool ArtUtils::IsNativeMethod(HInvoke* instruction) {
+  HGraph* graph = instruction->GetBlock()->GetGraph();
+  // fast path: flags of all methods resolved before compilation are captured in ModuleManager::initializeModules,
+  // methods resolved later are recorded below after their first lookup
+  bool is_native;
+  if (MethodFlagsTable::IsNative(&graph->GetDexFile(), instruction->GetDexMethodIndex(), &is_native)) {
+    return is_native;
+  }
+
   Locks::mutator_lock_->SharedLock(Thread::Current());
   ClassLinker *class_linker = Runtime::Current()->GetClassLinker();
-  HGraph* graph = instruction->GetBlock()->GetGraph();
 
 #ifdef BUILD_MARSHMALLOW
   ArtMethod *resolved_method = class_linker->FindDexCache(graph->GetDexFile())->GetResolvedMethod(
@@ -355,6 +699,7 @@ bool ArtUtils::IsNativeMethod(HInvoke* instruction) {
   bool result = resolved_method->IsNative();
   Locks::mutator_lock_->SharedUnlock(Thread::Current());
 
+  MethodFlagsTable::Record(&graph->GetDexFile(), instruction->GetDexMethodIndex(), result);
   return result;
 }
 
@@ -467,7 +812,7 @@ return argument_position;
 }
 
 void ArtUtils::SetupFunctionParams(HGraph* graph,
-                                   shared_ptr<const Injection>& injection,
+                                   const shared_ptr<const Injection>& injection,
                                    vector<HInstruction*>& function_parameters) {
   VLOG(artistd) << "ArtUtils::SetupFunctionParams()";
   if (injection->GetParameters().size() > 0) {
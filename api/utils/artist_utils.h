@@ -23,6 +23,10 @@
 #ifndef ART_API_UTILS_ARTIST_UTILS_H_
 #define ART_API_UTILS_ARTIST_UTILS_H_
 
+#include <map>
+#include <unordered_set>
+#include <vector>
+
 #include <optimizing/nodes.h>
 
 #include "optimizing/artist/api/env/codelib_environment.h"
@@ -30,11 +34,15 @@
 #include "optimizing/artist/api/env/codelib_symbols.h"
 #include "optimizing/artist/api/injection/injection.h"
 
+using std::map;
 using std::runtime_error;
 using std::shared_ptr;
+using std::unordered_set;
+using std::vector;
 
 class HGraph;
 class HInstruction;
+class MethodInfo;
 
 
 namespace art {
@@ -43,23 +51,40 @@ namespace art {
   class DexCompilationUnit;
   class Injection;
   class CodeLibEnvironment;
+  struct CodelibField;
 
   class ArtUtils {
    public:
     static string GetDexName(const string& dex_name, uint32_t dex_file_idx);
 
    public:
+    // The following lookups are backed by a hashed per-dex symbol index (see DexSymbolIndex) and hence run in constant
+    // time after the index for a dex file has been built once.
     static const DexFile::MethodId* FindMethodId(const DexFile* dex_file, const string& searched_method_name);
 
     static bool FindMethodIdx(const DexFile* dex_file, const string& searched_method_name, MethodIdx* result);
 
+    /**
+     * Resolves a whole set of method signatures in the given dex file at once. The dex file's method ids are only
+     * traversed a single time (to build its symbol index), no matter how many signatures are requested.
+     * In contrast to consecutive FindMethodIdx calls, resolution does not stop at the first unknown signature.
+     *
+     * @param dex_file the dex file to be searched
+     * @param signatures the fully qualified signatures of the searched methods
+     * @param result out parameter for the method indices of all signatures that were found
+     * @param missing out parameter for all signatures that could not be found, if not nullptr
+     * @return whether all signatures were found
+     */
+    static bool FindMethodIdxs(const DexFile* dex_file, const unordered_set<string>& signatures,
+                               map<MethodSignature, MethodIdx>* result, vector<MethodSignature>* missing = nullptr);
+
     static bool FindTypeIdxFromName(const DexFile* dex_file, const string & searched_type_name, TypeIdx* result);
 
     static bool FindFieldIdxFromName(const DexFile* dex_file, const string & searched_field_type, FieldIdx* result);
 
     /**
      * Check whether the given dexfile defines the given class. Note that for well-formed app dex files, there will only
-     * ever be one single dex file to define a particular class.
+     * ever be one single dex file to define a particular class. The class signature needs to match exactly.
      * The out parameter result is only changed if the dex file actually defines the searched class.
      *
      * @param dexfile the dex file to be searched
@@ -70,10 +95,25 @@ namespace art {
     static bool FindClassDefIdxFromName(const DexFile* dex_file, const  string & searched_signature,
                                                   ClassDefIdx* result = nullptr);
 
+    /**
+     * Finds the dex files that define the given classes with a single sweep over the class defs of all dex files.
+     * If several dex files define the same class, the first one (in the order of dex_files) is chosen, just as with
+     * consecutive FindClassDefIdxFromName calls.
+     *
+     * @param dex_files the dex files to be searched
+     * @param class_signatures the signatures of the searched classes
+     * @return the defining dex file for each class signature (same order), nullptr if there is none
+     */
+    static vector<const DexFile*> FindDefiningDexFiles(const vector<const DexFile*>& dex_files,
+                                                       const vector<string>& class_signatures);
+
     static void DumpTypes(const DexFile& dex_file);
 
     static string GetMethodName(HInvoke* invoke, bool signature = false);
-    static string GetMethodSignature(const HInvoke* invoke);
+    static void UpdateMaximumNumberOfOutVRegs(HGraph* graph, HInvoke* invoke);
+
+    static const string& GetMethodSignature(const HInvoke* invoke);
+    static const string& GetMethodSignature(const DexFile& dex_file, MethodIdx method_idx);
 
     static string GetDexFileName(const HGraph* graph);
 
@@ -81,7 +121,40 @@ namespace art {
 
     static HInstruction* InjectCodeLib(const HInstruction* instruction_cursor,
                                        shared_ptr<CodeLibEnvironment> env,
+                                       const MethodInfo& method_info,
                                        const bool entry_block_injection = true);
+    static void SinkCodeLib(HInstruction* codelib_instruction);
+    static HInstruction* InjectCodeLibClass(HInstruction* instruction_cursor, shared_ptr<CodeLibEnvironment> env);
+    static HInstruction* InjectStaticFieldGet(HInstruction* instruction_cursor,
+                                              HInstruction* codelib_class,
+                                              const CodelibField& field,
+                                              shared_ptr<CodeLibEnvironment> env,
+                                              const MethodInfo& method_info);
+    static HInstruction* InjectStaticFieldSet(HInstruction* instruction_cursor,
+                                              HInstruction* codelib_class,
+                                              const CodelibField& field,
+                                              HInstruction* value,
+                                              shared_ptr<CodeLibEnvironment> env,
+                                              const MethodInfo& method_info);
+    static HInstruction* InjectConditionalBlock(HInstruction* instruction_cursor,
+                                                HInstruction* condition,
+                                                bool guarded_if_true);
+    static HInstruction* InjectKillSwitchGuard(HInstruction* instruction_cursor,
+                                               shared_ptr<CodeLibEnvironment> env,
+                                               const MethodInfo& method_info);
+    static HInstruction* InjectCountdownGuard(HInstruction* instruction_cursor,
+                                              const CodelibField& counter,
+                                              uint32_t rate,
+                                              shared_ptr<CodeLibEnvironment> env,
+                                              const MethodInfo& method_info);
+    // function_params start with the codelib instance, unless the codelib uses static methods
+    // (@see CodeLib::usesStaticMethods)
+    static HInstruction* InjectMethodCall(HInstruction* instruction_cursor,
+                                       SignatureId method_signature,
+                                       vector<HInstruction*>& function_params,
+                                          shared_ptr<CodeLibEnvironment> env,
+                                       const Primitive::Type return_type = Primitive::Type::kPrimVoid,
+                                       const bool inject_before = true);
     static HInstruction* InjectMethodCall(HInstruction* instruction_cursor,
                                        const string& method_signature,
                                        vector<HInstruction*>& function_params,
@@ -94,7 +167,7 @@ namespace art {
 
     static uint32_t SetupInstructionArguments(HInvoke* instruction, vector<HInstruction*>& instruction_arguments);
     static void SetupFunctionParams(HGraph* graph,
-                                    shared_ptr<const Injection>& injection,
+                                    const shared_ptr<const Injection>& injection,
                                     vector<HInstruction*>& function_parameters);
 
     static bool IsNativeMethod(HInvoke* instruction);
@@ -0,0 +1,91 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "method_flags_table.h"
+
+#include "art_method-inl.h"
+#include "base/logging.h"
+#include "class_linker.h"
+#include "mirror/dex_cache-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+unordered_map<const DexFile*, MethodFlagsTable::Table>& MethodFlagsTable::GetTables() {
+  static unordered_map<const DexFile*, Table> tables;
+  return tables;
+}
+
+void MethodFlagsTable::Capture(const vector<const DexFile*>& dex_files) {
+  auto& tables = GetTables();
+  CHECK(tables.empty());
+
+  ScopedObjectAccess soa(Thread::Current());
+  ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+  auto pointer_size = class_linker->GetImagePointerSize();
+  for (auto dex_file : dex_files) {
+#ifdef BUILD_MARSHMALLOW
+    mirror::DexCache* dex_cache = class_linker->FindDexCache(*dex_file);
+#else
+    mirror::DexCache* dex_cache = class_linker->FindDexCache(soa.Self(), *dex_file, false);
+#endif
+    Table& table = tables[dex_file];
+    table.size = dex_file->NumMethodIds();
+    table.flags.reset(new atomic<uint8_t>[table.size]);
+    size_t resolved = 0;
+    for (uint32_t method_idx = 0; method_idx < table.size; method_idx++) {
+      ArtMethod* method = dex_cache->GetResolvedMethod(method_idx, pointer_size);
+      if (method == nullptr) {
+        table.flags[method_idx].store(UNRESOLVED, std::memory_order_relaxed);
+        continue;
+      }
+      table.flags[method_idx].store(RESOLVED | (method->IsNative() ? NATIVE : 0), std::memory_order_relaxed);
+      resolved++;
+    }
+    VLOG(artistd) << "MethodFlagsTable: captured " << resolved << "/" << table.size << " methods of "
+                  << dex_file->GetLocation();
+  }
+}
+
+bool MethodFlagsTable::IsNative(const DexFile* dex_file, MethodIdx method_idx, bool* is_native) {
+  auto& tables = GetTables();
+  auto found = tables.find(dex_file);
+  if (found == tables.end() || method_idx >= found->second.size) {
+    return false;
+  }
+  // a single byte holds all flags of a method, so no ordering with other memory is required
+  uint8_t flags = found->second.flags[method_idx].load(std::memory_order_relaxed);
+  if ((flags & RESOLVED) == 0) {
+    return false;
+  }
+  *is_native = (flags & NATIVE) != 0;
+  return true;
+}
+
+void MethodFlagsTable::Record(const DexFile* dex_file, MethodIdx method_idx, bool is_native) {
+  auto& tables = GetTables();
+  auto found = tables.find(dex_file);
+  if (found == tables.end() || method_idx >= found->second.size) {
+    return;
+  }
+  found->second.flags[method_idx].store(RESOLVED | (is_native ? NATIVE : 0), std::memory_order_relaxed);
+}
+
+}  // namespace art
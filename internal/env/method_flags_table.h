@@ -0,0 +1,84 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_ENV_METHOD_FLAGS_TABLE_H_
+#define ART_INTERNAL_ENV_METHOD_FLAGS_TABLE_H_
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "dex_file.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
+
+using std::atomic;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * Snapshot of the access flags of all resolved methods referenced by the app's dex files.
+ *
+ * Querying the runtime for a resolved method requires the mutator lock, which serializes parallel compiler threads.
+ * Instead, the flags are captured once for every method id before compilation starts. Methods that are resolved later
+ * are recorded after their first runtime query, so each of them takes the lock at most once per dex file. The set of
+ * tables is fixed after the capture and the flags are atomic, so neither lookups nor records need a lock.
+ */
+class MethodFlagsTable {
+ public:
+  /**
+   * Captures the flags of all currently resolved methods of the given dex files. Must be called a single time, before
+   * any compiler thread queries the table.
+   */
+  static void Capture(const vector<const DexFile*>& dex_files);
+
+  /**
+   * @param is_native set to whether the resolved method is native
+   * @return false if the method was not resolved when the flags were captured, i.e., the caller needs to ask the
+   *         runtime instead
+   */
+  static bool IsNative(const DexFile* dex_file, MethodIdx method_idx, bool* is_native);
+
+  /**
+   * Memoizes the flags of a method that was not resolved during the capture. Safe to call from any compiler thread.
+   */
+  static void Record(const DexFile* dex_file, MethodIdx method_idx, bool is_native);
+
+ private:
+  enum Flags : uint8_t {
+    UNRESOLVED = 0,
+    RESOLVED = 1 << 0,
+    NATIVE = 1 << 1,
+  };
+
+  struct Table {
+    size_t size;
+    // indexed by method idx
+    unique_ptr<atomic<uint8_t>[]> flags;
+  };
+
+  static unordered_map<const DexFile*, Table>& GetTables();
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_ENV_METHOD_FLAGS_TABLE_H_
@@ -0,0 +1,184 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "base/logging.h"
+#include "symbol_cache.h"
+
+using std::hex;
+using std::max;
+using std::ostringstream;
+using std::sort;
+
+namespace art {
+
+const uint32_t CachedSymbols::INVALID_IDX = 0xFFFFFFFF;
+
+const char SymbolCache::MAGIC[4] = { 'a', 's', 'c', '\0' };
+const uint32_t SymbolCache::VERSION = 2;
+
+static const uint64_t FNV64_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t FNV64_PRIME = 1099511628211ULL;
+
+static uint64_t HashString(uint64_t hash, const string& value) {
+  // the terminating '\0' separates consecutive strings
+  for (size_t i = 0; i <= value.size(); i++) {
+    hash ^= static_cast<uint8_t>(value.c_str()[i]);
+    hash *= FNV64_PRIME;
+  }
+  return hash;
+}
+
+static bool WriteFully(int fd, const void* data, size_t size) {
+  const char* bytes = reinterpret_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+SymbolCache::SymbolCache(const string& directory, shared_ptr<const CodeLib> codelib)
+    : _directory(directory), _signatures(codelib->getMethods().begin(), codelib->getMethods().end()) {
+  sort(_signatures.begin(), _signatures.end());
+  _codelib_key = HashString(FNV64_OFFSET_BASIS, codelib->getCodeClass());
+  _codelib_key = HashString(_codelib_key, codelib->getInstanceField());
+  // static codelibs do not resolve their instance field, so their entries must not be used in instance mode
+  _codelib_key = HashString(_codelib_key, codelib->usesStaticMethods() ? "static" : "instance");
+  _table_size = 0;
+  for (auto && signature : _signatures) {
+    _codelib_key = HashString(_codelib_key, signature);
+    SignatureId id = SignatureInterner::getInstance().intern(signature);
+    _signature_ids.push_back(id);
+    _table_size = max(_table_size, static_cast<size_t>(id) + 1);
+  }
+}
+
+string SymbolCache::getPath(const DexFile* dex_file, Role role) const {
+  ostringstream path;
+  path << _directory << "symbols_" << hex << dex_file->GetLocationChecksum()
+       << (role == CODELIB_DEX ? ".codelib" : ".app") << ".cache";
+  return path.str();
+}
+
+bool SymbolCache::load(const DexFile* dex_file, Role role, CachedSymbols* result) const {
+  CHECK(result != nullptr);
+  const string path = getPath(dex_file, role);
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VLOG(artistd) << "SymbolCache: no entry at " << path;
+    return false;
+  }
+  struct stat buf {};
+  const size_t expected_size = sizeof(Header) + _signatures.size() * sizeof(uint32_t);
+  if (fstat(fd, &buf) != 0 || static_cast<size_t>(buf.st_size) != expected_size) {
+    VLOG(artistd) << "SymbolCache: size mismatch for " << path;
+    close(fd);
+    return false;
+  }
+  void* mapping = mmap(nullptr, expected_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    VLOG(artistd) << "SymbolCache: could not map " << path;
+    return false;
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(mapping);
+  bool hit = memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+             && header->version == VERSION
+             && header->dex_checksum == dex_file->GetLocationChecksum()
+             && header->codelib_key == _codelib_key
+             && header->num_methods == _signatures.size();
+  if (hit) {
+    const uint32_t* method_idx = reinterpret_cast<const uint32_t*>(header + 1);
+    result->type_idx = header->type_idx;
+    result->class_def_idx = header->class_def_idx;
+    result->instance_field_idx = header->instance_field_idx;
+    result->method_idx.assign(_table_size, CachedSymbols::INVALID_IDX);
+    for (size_t i = 0; i < _signature_ids.size(); i++) {
+      result->method_idx[_signature_ids[i]] = method_idx[i];
+    }
+    VLOG(artistd) << "SymbolCache: hit for " << dex_file->GetLocation() << " (" << path << ")";
+  } else {
+    VLOG(artistd) << "SymbolCache: key mismatch for " << dex_file->GetLocation() << " (" << path << ")";
+  }
+  munmap(mapping, expected_size);
+  return hit;
+}
+
+void SymbolCache::store(const DexFile* dex_file, Role role, const CachedSymbols& symbols) const {
+  Header header {};
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.dex_checksum = dex_file->GetLocationChecksum();
+  header.num_methods = _signatures.size();
+  header.codelib_key = _codelib_key;
+  header.type_idx = symbols.type_idx;
+  header.class_def_idx = symbols.class_def_idx;
+  header.instance_field_idx = symbols.instance_field_idx;
+
+  vector<uint32_t> method_idx;
+  method_idx.reserve(_signature_ids.size());
+  for (SignatureId id : _signature_ids) {
+    method_idx.push_back(id < symbols.method_idx.size() ? symbols.method_idx[id] : CachedSymbols::INVALID_IDX);
+  }
+
+  // write to a unique temporary file first, so that neither concurrent readers nor concurrent writers (e.g., parallel
+  // dex2oat runs) ever observe or interleave with a partially written entry
+  const string path = getPath(dex_file, role);
+  string tmp_path = path + ".XXXXXX";
+  int fd = mkstemp(&tmp_path[0]);
+  if (fd < 0) {
+    VLOG(artist) << "SymbolCache: could not create a temporary file for " << path;
+    return;
+  }
+  // mkstemp only grants access to the owner, but entries are shared like the ones written before
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  const size_t method_idx_size = method_idx.size() * sizeof(uint32_t);
+  bool written = WriteFully(fd, &header, sizeof(header))
+                 && WriteFully(fd, method_idx.data(), method_idx_size);
+  if (close(fd) != 0 || !written) {
+    VLOG(artist) << "SymbolCache: could not write " << tmp_path;
+    unlink(tmp_path.c_str());
+    return;
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    VLOG(artist) << "SymbolCache: could not move " << tmp_path << " to " << path;
+    unlink(tmp_path.c_str());
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,111 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_ENV_SYMBOL_CACHE_H_
+#define ART_INTERNAL_ENV_SYMBOL_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dex_file.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
+#include "optimizing/artist/api/env/signature_interner.h"
+#include "optimizing/artist/api/modules/codelib.h"
+
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace art {
+
+/**
+ * The codelib symbols of a single dex file as they are stored in the symbol cache.
+ * Indices that are not known for a dex file are set to the corresponding INVALID_* value.
+ * Method indices are stored in a flat table indexed by signature id (@see SignatureInterner).
+ */
+struct CachedSymbols {
+  static const uint32_t INVALID_IDX;
+
+  uint32_t type_idx = INVALID_IDX;
+  uint32_t class_def_idx = INVALID_IDX;
+  uint32_t instance_field_idx = INVALID_IDX;
+  vector<MethodIdx> method_idx;
+};
+
+/**
+ * Persists resolved codelib symbols across compiler runs, e.g., when the same apk is recompiled after a module update.
+ *
+ * There is one cache file per dex file and role (app dex file or codelib dex file). Each file starts with a fixed-size
+ * header that contains the dex file's location checksum and a key derived from the codelib's class, instance field,
+ * dispatch mode and method signatures, followed by the method indices in sorted signature order. Files are
+ * memory-mapped and the mapped indices are copied straight into the signature id table, using a sorted-position-to-id
+ * mapping that is computed once per cache, so loading neither parses nor hashes any strings. If the checksum, key or
+ * layout does not match, the cache reports a miss and the caller resolves the symbols from the dex file and overwrites
+ * the stale entry.
+ */
+class SymbolCache {
+ public:
+  enum Role { APP_DEX, CODELIB_DEX };
+
+  SymbolCache(const string& directory, shared_ptr<const CodeLib> codelib);
+
+  /**
+   * Loads the cached symbols for dex_file.
+   *
+   * @return true on a cache hit, false if there is no (valid) entry for dex_file and the current codelib
+   */
+  bool load(const DexFile* dex_file, Role role, CachedSymbols* result) const;
+
+  /**
+   * Stores the symbols for dex_file. Failures are logged and otherwise ignored since the cache is only an optimization.
+   */
+  void store(const DexFile* dex_file, Role role, const CachedSymbols& symbols) const;
+
+ private:
+  struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t dex_checksum;
+    uint32_t num_methods;
+    uint64_t codelib_key;
+    uint32_t type_idx;
+    uint32_t class_def_idx;
+    uint32_t instance_field_idx;
+    uint32_t padding;
+  };
+
+  static const char MAGIC[4];
+  static const uint32_t VERSION;
+
+  string getPath(const DexFile* dex_file, Role role) const;
+
+  const string _directory;
+  // codelib method signatures in the order their indices are stored
+  vector<MethodSignature> _signatures;
+  // signature id of each entry in _signatures
+  vector<SignatureId> _signature_ids;
+  // size of the id tables handed out by load
+  size_t _table_size;
+  uint64_t _codelib_key;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_ENV_SYMBOL_CACHE_H_
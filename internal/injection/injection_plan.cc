@@ -0,0 +1,174 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "injection_plan.h"
+#include "base/logging.h"
+#include "optimizing/artist/api/env/signature_interner.h"
+#include "optimizing/artist/api/io/error_handler.h"
+#include "optimizing/artist/internal/injection/visitor_keys.h"
+
+using std::call_once;
+using std::find;
+using std::lock_guard;
+using std::make_shared;
+using std::map;
+using std::move;
+using std::mutex;
+using std::once_flag;
+using std::unique_ptr;
+
+namespace art {
+
+static const size_t MAX_DISPATCH_SLOTS = 64;
+
+shared_ptr<const InjectionPlan> InjectionPlan::Get(const CodeLibEnvironment* module_env,
+                                                   const vector<const DexFile*>& dex_files,
+                                                   const InjectionProvider& provider) {
+  // without a codelib there is nothing that injections could call, so such modules do not inject anything
+  if (module_env == nullptr) {
+    static const shared_ptr<const InjectionPlan> empty_plan =
+        make_shared<const InjectionPlan>(vector<shared_ptr<const Injection>>(), dex_files);
+    VLOG(artistd) << "InjectionPlan: module without codelib environment, using an empty plan";
+    return empty_plan;
+  }
+  struct Entry {
+    once_flag flag;
+    shared_ptr<const InjectionPlan> plan;
+  };
+  static mutex entries_lock;
+  static map<const CodeLibEnvironment*, unique_ptr<Entry>> entries;
+
+  Entry* entry;
+  {
+    lock_guard<mutex> guard(entries_lock);
+    auto& slot = entries[module_env];
+    if (slot == nullptr) {
+      slot.reset(new Entry());
+    }
+    entry = slot.get();
+  }
+  // the plan is built outside of the registry lock so that plans of different modules can be built concurrently.
+  call_once(entry->flag, [entry, module_env, &dex_files, &provider]() {
+    entry->plan = make_shared<const InjectionPlan>(provider(), dex_files, module_env->getCodeLib());
+  });
+  return entry->plan;
+}
+
+InjectionPlan::InjectionPlan(vector<shared_ptr<const Injection>> injections, const vector<const DexFile*>& dex_files,
+                             shared_ptr<const CodeLib> codelib)
+    : _injections(move(injections)), _target_index(_injections, dex_files), _dispatcher(SignatureInterner::INVALID_ID) {
+  VLOG(artistd) << "InjectionPlan: building plan for " << _injections.size() << " injections";
+
+  int32_t target_counter = 0;
+  for (auto && injection : _injections) {
+    VLOG(artistd) << "InjectionPlan: Method:      " << injection->GetSignature();
+    auto& injection_targets = injection->GetInjectionTargets();
+
+    VLOG(artistd) << "InjectionPlan: Local TargetCount  #" << injection_targets.size();
+    // TODO Bug: Using Injection with multiple targets that have the same InjectionTarget
+    //           Leads to duplicate injections
+    for (auto && target : injection_targets) {
+      switch (target->GetTargetType()) {
+        case InjectionTarget::METHOD_CALL_BEFORE:
+        case InjectionTarget::METHOD_CALL_AFTER:
+          ++target_counter;
+          _injection_table[VisitorKeys::H_INVOKE].push_back(injection);
+          _injection_table[VisitorKeys::H_INVOKE_INTERFACE].push_back(injection);
+          _injection_table[VisitorKeys::H_INVOKE_STATIC_OR_DIRECT].push_back(injection);
+          _injection_table[VisitorKeys::H_INVOKE_VIRTUAL].push_back(injection);
+          break;
+        case InjectionTarget::METHOD_START:
+        case InjectionTarget::METHOD_END:
+          ++target_counter;
+          _injection_table[VisitorKeys::H_RETURN].push_back(injection);
+          _injection_table[VisitorKeys::H_RETURN_VOID].push_back(injection);
+          break;
+        case InjectionTarget::NO_INJECTION:
+        default:
+          VLOG(artistd) << "Nothing to inject";
+          continue;
+      }
+    }
+  }
+  // injections that call a dispatched codelib method without parameters can be coalesced
+  if (codelib != nullptr && !codelib->getDispatcher().empty()) {
+    auto dispatched = codelib->getDispatchedMethods();
+    if (dispatched.size() > MAX_DISPATCH_SLOTS) {
+      ErrorHandler::abortCompilation("InjectionPlan: the codelib dispatches more than 64 methods");
+    }
+    _dispatcher = SignatureInterner::getInstance().intern(codelib->getDispatcher());
+    for (auto && injection : _injections) {
+      // sampled and loop-aware injections are placed individually and cannot share a call
+      if (injection->GetSnippet() != nullptr || !injection->GetParameters().empty()
+          || injection->GetSamplingRate() > 1 || injection->GetLoopMode() != Injection::EVERY_ITERATION) {
+        continue;
+      }
+      auto slot = find(dispatched.begin(), dispatched.end(), injection->GetSignature());
+      if (slot != dispatched.end()) {
+        _dispatch_slots.emplace(injection.get(), static_cast<uint32_t>(slot - dispatched.begin()));
+      }
+    }
+    VLOG(artistd) << "InjectionPlan: " << _dispatch_slots.size() << " injections are dispatched through "
+                  << codelib->getDispatcher();
+  }
+
+  VLOG(artistd) << "InjectionPlan: InjectionCount Total #" << _injections.size();
+  VLOG(artistd) << "InjectionPlan: TargetCount Total    #" << target_counter;
+}
+
+const vector<shared_ptr<const Injection>>& InjectionPlan::GetInjections() const {
+  return _injections;
+}
+
+const InjectionPlan::InjectionTable& InjectionPlan::GetInjectionTable() const {
+  return _injection_table;
+}
+
+const vector<shared_ptr<const Injection>>& InjectionPlan::GetInjectionTableEntry(VisitorKeys::Key callback_key) const {
+  DCHECK_LT(callback_key, VisitorKeys::NUM_KEYS);
+  return _injection_table[callback_key];
+}
+
+bool InjectionPlan::MatchesTarget(const Target* target, const DexFile* dex_file, MethodIdx method_idx) const {
+  return _target_index.Matches(target, dex_file, method_idx);
+}
+
+bool InjectionPlan::MayHaveInjectionSites(const DexFile* dex_file, MethodIdx method_idx,
+                                          const DexFile::CodeItem* code_item) const {
+  return _target_index.MayHaveInjectionSites(dex_file, method_idx, code_item);
+}
+
+SignatureId InjectionPlan::GetDispatcher() const {
+  return _dispatcher;
+}
+
+bool InjectionPlan::GetDispatchSlot(const Injection* injection, uint32_t* slot) const {
+  auto found = _dispatch_slots.find(injection);
+  if (found == _dispatch_slots.end()) {
+    return false;
+  }
+  *slot = found->second;
+  return true;
+}
+
+}  // namespace art
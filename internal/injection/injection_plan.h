@@ -0,0 +1,108 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_INJECTION_INJECTION_PLAN_H_
+#define ART_INTERNAL_INJECTION_INJECTION_PLAN_H_
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "optimizing/artist/api/env/codelib_environment.h"
+#include "optimizing/artist/api/env/signature_interner.h"
+#include "optimizing/artist/api/injection/injection.h"
+#include "optimizing/artist/internal/injection/target_index.h"
+#include "optimizing/artist/internal/injection/visitor_keys.h"
+
+using std::array;
+using std::function;
+using std::shared_ptr;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * Immutable, preprocessed form of the injections declared by an injection module: the injections themselves and, for
+ * each visitor key (@see VisitorKeys), the injections that need to be checked when visiting such an instruction. The
+ * latter is a fixed-size array indexed by key, so a lookup is a single indexed load that neither hashes nor copies.
+ *
+ * Since a module's injections do not depend on the method being compiled, the plan is built a single time per module
+ * and then shared by all of its pass instances and compiler threads.
+ */
+class InjectionPlan {
+ public:
+  typedef function<vector<shared_ptr<const Injection>>()> InjectionProvider;
+  typedef array<vector<shared_ptr<const Injection>>, VisitorKeys::NUM_KEYS> InjectionTable;
+
+  /**
+   * Provides the plan for the given module. The first caller builds it from the injections returned by `provider`,
+   * all later callers (on any thread) receive the same instance.
+   *
+   * @param module_env the module's codelib environment, which exists exactly once per module. Modules without one
+   *                   (nullptr) receive an empty plan and their provider is never invoked.
+   * @param dex_files the app dex files, i.e., the dex files whose methods are instrumented
+   * @param provider invoked at most once per module to obtain the module's injections
+   */
+  static shared_ptr<const InjectionPlan> Get(const CodeLibEnvironment* module_env,
+                                             const vector<const DexFile*>& dex_files,
+                                             const InjectionProvider& provider);
+
+  InjectionPlan(vector<shared_ptr<const Injection>> injections, const vector<const DexFile*>& dex_files,
+                shared_ptr<const CodeLib> codelib = nullptr);
+
+  const vector<shared_ptr<const Injection>>& GetInjections() const;
+  const InjectionTable& GetInjectionTable() const;
+  // empty if there are no injections for callback_key
+  const vector<shared_ptr<const Injection>>& GetInjectionTableEntry(VisitorKeys::Key callback_key) const;
+  // @see TargetIndex::Matches
+  bool MatchesTarget(const Target* target, const DexFile* dex_file, MethodIdx method_idx) const;
+  // @see TargetIndex::MayHaveInjectionSites
+  bool MayHaveInjectionSites(const DexFile* dex_file, MethodIdx method_idx, const DexFile::CodeItem* code_item) const;
+
+  /**
+   * @return the codelib's dispatcher (@see CodeLib::getDispatcher) or SignatureInterner::INVALID_ID if there is none
+   */
+  SignatureId GetDispatcher() const;
+
+  /**
+   * @param slot set to the injection's bit in the dispatcher argument
+   * @return whether the injection can be coalesced into a dispatcher call
+   */
+  bool GetDispatchSlot(const Injection* injection, uint32_t* slot) const;
+
+ private:
+  const vector<shared_ptr<const Injection>> _injections;
+
+  // indexed by VisitorKeys::Key
+  InjectionTable _injection_table;
+
+  const TargetIndex _target_index;
+
+  SignatureId _dispatcher;
+  unordered_map<const Injection*, uint32_t> _dispatch_slots;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_INJECTION_INJECTION_PLAN_H_
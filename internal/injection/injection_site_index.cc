@@ -0,0 +1,65 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "injection_site_index.h"
+#include "base/logging.h"
+
+namespace art {
+
+InjectionSiteIndex::InjectionSiteIndex(HGraph* graph) : _sites(graph->GetArena()->Adapter(kArenaAllocMisc)) {
+  VisitorKeys::Key key;
+  for (HBasicBlock* block : graph->GetBlocks()) {
+    if (block == nullptr) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (GetKey(it.Current(), &key)) {
+        _sites.push_back(it.Current());
+      }
+    }
+  }
+  VLOG(artistd) << "InjectionSiteIndex: found " << _sites.size() << " injection sites";
+}
+
+const ArenaVector<HInstruction*>& InjectionSiteIndex::GetSites() const {
+  return _sites;
+}
+
+bool InjectionSiteIndex::GetKey(HInstruction* instruction, VisitorKeys::Key* key) {
+  // mirrors the dispatch of HGraphVisitor: only the most specific Visit* method of an instruction is called
+  if (instruction->IsInvokeStaticOrDirect()) {
+    *key = VisitorKeys::H_INVOKE_STATIC_OR_DIRECT;
+  } else if (instruction->IsInvokeVirtual()) {
+    *key = VisitorKeys::H_INVOKE_VIRTUAL;
+  } else if (instruction->IsInvokeInterface()) {
+    *key = VisitorKeys::H_INVOKE_INTERFACE;
+  } else if (instruction->IsReturn()) {
+    *key = VisitorKeys::H_RETURN;
+  } else if (instruction->IsReturnVoid()) {
+    *key = VisitorKeys::H_RETURN_VOID;
+  } else if (instruction->IsInvoke()) {
+    // any other invoke, e.g., an unresolved one
+    *key = VisitorKeys::H_INVOKE;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace art
@@ -0,0 +1,55 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_INJECTION_INJECTION_SITE_INDEX_H_
+#define ART_INTERNAL_INJECTION_INJECTION_SITE_INDEX_H_
+
+#include "base/arena_containers.h"
+#include "base/arena_object.h"
+#include "optimizing/nodes.h"
+#include "optimizing/artist/internal/injection/visitor_keys.h"
+
+namespace art {
+
+/**
+ * The instructions of a graph that injections can be attached to, i.e., invokes and returns, in insertion order.
+ *
+ * The index is collected with a single sweep over the graph and allocated in the graph's arena, so it lives exactly as
+ * long as the graph. It is shared by all injection passes of the same method (@see MethodInfo::GetInjectionSites), so
+ * instructions injected by earlier passes are not sites for later ones.
+ */
+class InjectionSiteIndex : public ArenaObject<kArenaAllocMisc> {
+ public:
+  explicit InjectionSiteIndex(HGraph* graph);
+
+  const ArenaVector<HInstruction*>& GetSites() const;
+
+  /**
+   * @param key set to the visitor key of instruction if it is a site
+   * @return whether instruction is an injection site
+   */
+  static bool GetKey(HInstruction* instruction, VisitorKeys::Key* key);
+
+ private:
+  ArenaVector<HInstruction*> _sites;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_INJECTION_INJECTION_SITE_INDEX_H_
@@ -37,7 +37,60 @@ HInjectionVisitor::HInjectionVisitor(HInjectionArtist* parent_artist,
   VLOG(artistd) << "HInjectionVisitor() Injections # " << artist->GetInjections().size();
 }
 
-void HInjectionVisitor::InjectInstruction(HInstruction* instruction, shared_ptr<const Injection>& injection) {
+void HInjectionVisitor::VisitSites(const InjectionSiteIndex& sites) {
+  VisitorKeys::Key key;
+  for (HInstruction* instruction : sites.GetSites()) {
+    // instructions might have been removed from the graph by a previous pass
+    if (instruction->GetBlock() == nullptr || !InjectionSiteIndex::GetKey(instruction, &key)) {
+      continue;
+    }
+    if (artist->GetInjectionTableEntry(key).empty()) {
+      continue;
+    }
+    instruction->Accept(this);
+  }
+}
+
+/**
+ * Injects all matching injections at the given instruction. If the codelib provides a dispatcher, the dispatchable
+ * injections are not emitted one by one but coalesced into a single dispatcher call per placement, after the
+ * individually emitted ones.
+ */
+void HInjectionVisitor::InjectInstructions(HInstruction* instruction,
+                                           const vector<shared_ptr<const Injection>>& injections) {
+  DispatchMasks masks;
+  for (auto && injection : injections) {
+    InjectInstruction(instruction, injection, &masks);
+  }
+  InjectDispatch(instruction, InjectionTarget::METHOD_START, masks.start);
+  InjectDispatch(instruction, InjectionTarget::METHOD_CALL_BEFORE, masks.before);
+  InjectDispatch(instruction, InjectionTarget::METHOD_CALL_AFTER, masks.after);
+}
+
+void HInjectionVisitor::InjectDispatch(HInstruction* instruction, InjectionTarget target_type, uint64_t mask) {
+  if (mask == 0) {
+    return;
+  }
+  VLOG(artistd) << "HInjectionVisitor::InjectDispatch() mask: " << std::hex << mask << std::dec;
+  // the codelib instance is requested first so that it is available at the (entry block) location
+  std::vector<HInstruction*> function_params;
+  if (!artist->getCodeLibEnvironment()->usesStaticMethods()) {
+    function_params.push_back(artist->GetCodeLibInstruction());
+  }
+  function_params.push_back(graph->GetLongConstant(static_cast<int64_t>(mask)));
+  HInstruction* location;
+  bool before;
+  GetCallLocation(instruction, target_type, nullptr, &location, &before);
+  ArtUtils::InjectMethodCall(location,
+                             artist->GetInjectionPlan().GetDispatcher(),
+                             function_params,
+                             artist->getCodeLibEnvironment(),
+                             Primitive::Type::kPrimVoid,
+                             before);
+}
+
+void HInjectionVisitor::InjectInstruction(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                                          DispatchMasks* masks) {
   DCHECK(instruction != nullptr);
   VLOG(artistd) << "HInjectionVisitor::InjectInstruction() instruction: " << instruction << std::flush;
 //  VLOG(artist) << "HInjectionVisitor::InjectInstruction() injection:   " << &injection<< std::flush;
@@ -54,72 +107,300 @@ void HInjectionVisitor::InjectInstruction(HInstruction* instruction, shared_ptr<
                   << Parameter::TypeToString(parameter->GetType());
   }
 
+  const DexFile* dex_file = &graph->GetDexFile();
   for (auto && target : injection->GetInjectionTargets()) {
-    std::string check_signature;
+    // the method whose signature is checked against the target, matching is done on pre-resolved method indices.
+    MethodIdx check_idx;
 
     auto target_type = target->GetTargetType();
 
     switch (target_type) {
       case InjectionTarget::METHOD_CALL_BEFORE:
-        check_signature = GetInvokedMethod(instruction);
-        break;
       case InjectionTarget::METHOD_CALL_AFTER:
-        check_signature = GetInvokedMethod(instruction);
+        check_idx = instruction->IsInvoke() ? instruction->AsInvoke()->GetDexMethodIndex() : DexFile::kDexNoIndex;
         break;
       case InjectionTarget::METHOD_START:
       case InjectionTarget::METHOD_END:
-        check_signature = this->artist->GetMethodInfo().GetMethodName(true);
+        check_idx = graph->GetMethodIdx();
         break;
       case InjectionTarget::NO_INJECTION:
       default:
         VLOG(artistd) << "HInjectionVisitor::InjectInstruction() DONE: InjectionTarget::NONE";
         continue;
     }
-    VLOG(artistd) << "HInjectionVisitor::InjectInstruction() check_signature:  " << check_signature;
+    VLOG(artistd) << "HInjectionVisitor::InjectInstruction() check_idx:        " << check_idx;
+    VLOG(artistd) << "HInjectionVisitor::InjectInstruction() TARGET_SIGNATURE: " << target->GetTargetSignature();
 
-    const std::string TARGET_SIGNATURE = target->GetTargetSignature();
-    VLOG(artistd) << "HInjectionVisitor::InjectInstruction() TARGET_SIGNATURE: " << TARGET_SIGNATURE;
-
-    if (TARGET_SIGNATURE == Target::GENERIC_TARGET
-        || MethodSignatureContains(check_signature, TARGET_SIGNATURE)) {
-      VLOG(artistd) << "HInjectionVisitor::InjectInstruction() GENERIC Signature OK:   "
-                    << "TARGET: " << TARGET_SIGNATURE
+    if (artist->GetInjectionPlan().MatchesTarget(target.get(), dex_file, check_idx)) {
+      VLOG(artistd) << "HInjectionVisitor::InjectInstruction() Signature OK:   "
+                    << "TARGET: " << target->GetTargetSignature()
                     << " | "
-                    << "CHECK: " << check_signature;
-      // Inject only if it's not been injected, reuse first injection.
-      HInstruction* injection_lib;
-
-      injection_lib = artist->GetCodeLibInstruction();
-
+                    << "CHECK: " << check_idx;
+      // snippets are spliced in place, no codelib call required
+      if (injection->GetSnippet() != nullptr) {
+        HInstruction* snippet_cursor;
+        if (target_type == InjectionTarget::METHOD_START) {
+          snippet_cursor = graph->GetEntryBlock()->GetLastInstruction();
+        } else if (target_type == InjectionTarget::METHOD_CALL_AFTER) {
+          snippet_cursor = instruction->GetNext();
+        } else {
+          snippet_cursor = instruction;
+        }
+        injection->GetSnippet()->Emit(snippet_cursor, artist->getCodeLibEnvironment(), artist->GetMethodInfo());
+        continue;
+      }
+      uint32_t slot;
+      if (artist->GetInjectionPlan().GetDispatchSlot(injection.get(), &slot)) {
+        const uint64_t bit = UINT64_C(1) << slot;
+        if (target_type == InjectionTarget::METHOD_START) {
+          masks->start |= bit;
+        } else if (target_type == InjectionTarget::METHOD_CALL_AFTER) {
+          masks->after |= bit;
+        } else {
+          masks->before |= bit;
+        }
+        continue;
+      }
+      HLoopInformation* loop_info = instruction->GetBlock()->GetLoopInformation();
+      const bool call_site = target_type == InjectionTarget::METHOD_CALL_BEFORE
+                             || target_type == InjectionTarget::METHOD_CALL_AFTER;
+      if (call_site && loop_info != nullptr && injection->GetLoopMode() != Injection::EVERY_ITERATION) {
+        if (InjectLoopInstruction(instruction, injection, loop_info)) {
+          continue;
+        }
+        VLOG(artistd) << "HInjectionVisitor::InjectInstruction() loop not supported, injecting at the site";
+      }
       std::vector<HInstruction*> function_params;
-      function_params.push_back(injection_lib);
+      // static codelib methods are called without the instance
+      if (!artist->getCodeLibEnvironment()->usesStaticMethods()) {
+        // Inject only if it's not been injected, reuse first injection.
+        HInstruction* injection_lib;
 
-      ArtUtils::SetupFunctionParams(graph, injection, function_params);
+        injection_lib = artist->GetCodeLibInstruction();
+        function_params.push_back(injection_lib);
+      }
 
-      HInstruction* injection_location = nullptr;
-      if (target_type == InjectionTarget::METHOD_START) {
-        injection_location = instruction->GetBlock()->GetGraph()->GetEntryBlock()->GetLastInstruction();
-      } else {
-        injection_location = instruction;
+      ArtUtils::SetupFunctionParams(graph, injection, function_params);
+      // a single execution of the site
+      if (injection->GetLoopMode() == Injection::AGGREGATE) {
+        function_params.push_back(graph->GetIntConstant(1));
       }
 
-      bool before = (target_type != InjectionTarget::METHOD_CALL_AFTER);
+      HInstruction* injection_location;
+      bool before;
+      GetCallLocation(instruction, target_type, injection.get(), &injection_location, &before);
 
       ArtUtils::InjectMethodCall(injection_location,
-                                 injection->GetSignature(),
+                                 injection->GetSignatureId(),
                                  function_params,
                                  artist->getCodeLibEnvironment(),
                                  Primitive::Type::kPrimVoid,
                                  before);
     } else {
-      VLOG(artistd) << "HInjectionVisitor::InjectInstruction() Signature Fail! HAVE:   " << check_signature << std::endl
-                    << "HInjectionVisitor::InjectInstruction() Signature Fail! TARGET: " << TARGET_SIGNATURE;
+      VLOG(artistd) << "HInjectionVisitor::InjectInstruction() Signature Fail! HAVE:   " << check_idx << std::endl
+                    << "HInjectionVisitor::InjectInstruction() Signature Fail! TARGET: " << target->GetTargetSignature();
     }
   }
   VLOG(artistd) << "HInjectionVisitor::InjectInstruction() DONE";
 }
 
-std::string HInjectionVisitor::GetInvokedMethod(HInstruction* instruction) {
+/**
+ * Injects a loop-invariant or aggregating injection for a call site inside the given (innermost) loop.
+ *
+ * @return false if the loop is not supported and the injection needs to be injected at the site as usual
+ */
+bool HInjectionVisitor::InjectLoopInstruction(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                                              HLoopInformation* loop_info) {
+  switch (injection->GetLoopMode()) {
+    case Injection::LOOP_INVARIANT:
+      return HoistInjection(instruction, injection);
+    case Injection::AGGREGATE:
+      return AggregateInjection(instruction, injection, loop_info);
+    case Injection::EVERY_ITERATION:
+    default:
+      return false;
+  }
+}
+
+/**
+ * Injects the call once in the pre-header of the outermost loop that contains the site.
+ */
+bool HInjectionVisitor::HoistInjection(HInstruction* instruction, const shared_ptr<const Injection>& injection) {
+  HLoopInformation* outermost = nullptr;
+  for (HLoopInformationOutwardIterator it(*instruction->GetBlock()); !it.Done(); it.Advance()) {
+    outermost = it.Current();
+  }
+#ifndef BUILD_MARSHMALLOW
+  if (outermost->IsIrreducible()) {
+    return false;
+  }
+#endif
+  if (!artist->ClaimLoopInjection(injection.get(), outermost)) {
+    VLOG(artistd) << "HInjectionVisitor::HoistInjection() already hoisted";
+    return true;
+  }
+  std::vector<HInstruction*> function_params;
+  if (!artist->getCodeLibEnvironment()->usesStaticMethods()) {
+    function_params.push_back(artist->GetCodeLibInstruction());
+  }
+  ArtUtils::SetupFunctionParams(graph, injection, function_params);
+
+  HInstruction* location;
+  bool before;
+  GetCallLocation(outermost->GetPreHeader()->GetLastInstruction(), InjectionTarget::METHOD_CALL_BEFORE,
+                  injection.get(), &location, &before);
+  ArtUtils::InjectMethodCall(location,
+                             injection->GetSignatureId(),
+                             function_params,
+                             artist->getCodeLibEnvironment(),
+                             Primitive::Type::kPrimVoid,
+                             before);
+  VLOG(artistd) << "HInjectionVisitor::HoistInjection() hoisted to block " << location->GetBlock()->GetBlockId();
+  return true;
+}
+
+/**
+ * Counts the executions of the site in a loop phi and passes the count to a single call on each loop exit:
+ *
+ *   header:  count = phi(0, next)
+ *   site:    next = count + 1
+ *   exit:    call(..., next or count)
+ *
+ * Only simple loops are supported: a single back edge that is dominated by the site, so the site is executed exactly
+ * once per completed iteration, and loop exits that are not shared with other paths. Whether an exit sees `next` or
+ * `count` depends on whether the site dominates the exiting block. Exits by exceptions are not counted.
+ */
+bool HInjectionVisitor::AggregateInjection(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                                           HLoopInformation* loop_info) {
+  HBasicBlock* site_block = instruction->GetBlock();
+  if (loop_info->GetBackEdges().size() != 1 || !site_block->Dominates(loop_info->GetBackEdges()[0])) {
+    return false;
+  }
+#ifndef BUILD_MARSHMALLOW
+  if (loop_info->IsIrreducible()) {
+    return false;
+  }
+#endif
+  // loop exits, i.e., edges from blocks inside of the loop to their (only) successor outside of the loop
+  std::vector<std::pair<HBasicBlock*, HBasicBlock*>> exits;
+  for (HBlocksInLoopIterator it(*loop_info); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+#ifndef BUILD_MARSHMALLOW
+    if (block->IsInTry()) {
+      return false;
+    }
+#endif
+    for (HBasicBlock* successor : block->GetSuccessors()) {
+      if (loop_info->Contains(*successor)) {
+        continue;
+      }
+      if (successor->GetPredecessors().size() != 1) {
+        return false;
+      }
+      exits.emplace_back(block, successor);
+    }
+  }
+  if (exits.empty()) {
+    return false;
+  }
+
+  ArenaAllocator* allocator = graph->GetArena();
+  HBasicBlock* header = loop_info->GetHeader();
+  HPhi* count = new (allocator) HPhi(allocator, kNoRegNumber, header->GetPredecessors().size(), Primitive::kPrimInt);
+  HAdd* next = new (allocator) HAdd(Primitive::kPrimInt, count, graph->GetIntConstant(1));
+  for (size_t i = 0; i < header->GetPredecessors().size(); i++) {
+    HBasicBlock* predecessor = header->GetPredecessors()[i];
+    count->SetRawInputAt(i, loop_info->IsBackEdge(*predecessor) ? next : graph->GetIntConstant(0));
+  }
+  header->AddPhi(count);
+  site_block->InsertInstructionBefore(next, instruction);
+
+  for (auto && exit : exits) {
+    std::vector<HInstruction*> function_params;
+    if (!artist->getCodeLibEnvironment()->usesStaticMethods()) {
+      function_params.push_back(artist->GetCodeLibInstruction());
+    }
+    ArtUtils::SetupFunctionParams(graph, injection, function_params);
+    function_params.push_back(site_block->Dominates(exit.first) ? static_cast<HInstruction*>(next) : count);
+
+    HInstruction* location;
+    bool before;
+    GetCallLocation(exit.second->GetFirstInstruction(), InjectionTarget::METHOD_CALL_BEFORE, injection.get(),
+                    &location, &before);
+    ArtUtils::InjectMethodCall(location,
+                               injection->GetSignatureId(),
+                               function_params,
+                               artist->getCodeLibEnvironment(),
+                               Primitive::Type::kPrimVoid,
+                               before);
+  }
+  VLOG(artistd) << "HInjectionVisitor::AggregateInjection() aggregated over " << exits.size() << " loop exits";
+  return true;
+}
+
+/**
+ * Determines where the codelib call for the given target type is injected. If the codelib has a kill switch or the
+ * injection is sampled, the guards are emitted first and the call is placed in the guarded block.
+ *
+ * @param injection the injection to be called, nullptr for dispatcher calls
+ */
+void HInjectionVisitor::GetCallLocation(HInstruction* instruction, InjectionTarget target_type,
+                                        const Injection* injection, HInstruction** location, bool* before) {
+  if (target_type == InjectionTarget::METHOD_START) {
+    *location = graph->GetEntryBlock()->GetLastInstruction();
+  } else {
+    *location = instruction;
+  }
+  *before = (target_type != InjectionTarget::METHOD_CALL_AFTER);
+
+  auto env = artist->getCodeLibEnvironment();
+  const bool sampled = injection != nullptr && injection->GetSamplingRate() > 1;
+  if (!env->hasKillSwitch() && !sampled) {
+    return;
+  }
+  HInstruction* guard_location = GetGuardLocation(instruction, target_type);
+  if (env->hasKillSwitch()) {
+    guard_location = ArtUtils::InjectKillSwitchGuard(guard_location, env, artist->GetMethodInfo());
+  }
+  if (sampled) {
+    guard_location = ArtUtils::InjectCountdownGuard(guard_location, env->getField(injection->GetSamplingCounter()),
+                                                    injection->GetSamplingRate(), env, artist->GetMethodInfo());
+  }
+  *location = guard_location;
+  *before = true;
+}
+
+/**
+ * Provides the instruction in front of which guards for the given target type are placed. The entry block cannot be
+ * split, so method start guards are placed at the start of its successor. If the successor is a merge point or a loop
+ * header, the entry edge is split first, like SimplifyCFG does for critical edges, so that the guards are executed
+ * exactly once per invocation.
+ */
+HInstruction* HInjectionVisitor::GetGuardLocation(HInstruction* instruction, InjectionTarget target_type) {
+  switch (target_type) {
+    case InjectionTarget::METHOD_START: {
+      HBasicBlock* entry_block = graph->GetEntryBlock();
+      HBasicBlock* first_block = entry_block->GetSuccessors()[0];
+      if (first_block->GetPredecessors().size() != 1 || first_block->IsLoopHeader()) {
+        // keeps the predecessor index of the entry block, so phis of the successor stay valid
+        HBasicBlock* split = graph->SplitEdge(entry_block, first_block);
+        split->AddInstruction(new (graph->GetArena()) HGoto());
+        graph->ClearDominanceInformation();
+        graph->ComputeDominanceInformation();
+        VLOG(artistd) << "HInjectionVisitor::GetGuardLocation() split the entry edge for method start guards";
+        first_block = split;
+      }
+      return first_block->GetFirstInstruction();
+    }
+    case InjectionTarget::METHOD_CALL_AFTER:
+      return instruction->GetNext();
+    default:
+      return instruction;
+  }
+}
+
+const std::string& HInjectionVisitor::GetInvokedMethod(HInstruction* instruction) {
+  static const std::string NO_METHOD;
   if (instruction->IsInvokeStaticOrDirect()) {
     HInvokeStaticOrDirect* invoke = reinterpret_cast<HInvokeStaticOrDirect*>(instruction);
     invoke->GetDexMethodIndex();
@@ -137,7 +418,7 @@ std::string HInjectionVisitor::GetInvokedMethod(HInstruction* instruction) {
     invoke->GetDexMethodIndex();
     return ArtUtils::GetMethodSignature(reinterpret_cast<HInvoke*>(instruction));
   }
-  return "";
+  return NO_METHOD;
 }
 
 /**
@@ -190,41 +471,42 @@ bool HInjectionVisitor::MethodSignatureContains(const std::string& method_signat
 
 void HInjectionVisitor::VisitInvoke(HInvoke* instruction) {
   DCHECK(instruction != nullptr);
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvoke() Injections #" << checkInjections.size()
                 << " INVOKED: " << GetInvokedMethod(instruction);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvoke() Injections # " << checkInjections.size();
 
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitInvoke() DONE";
 }
 
+#ifndef BUILD_MARSHMALLOW
+void HInjectionVisitor::VisitInvokeUnresolved(HInvokeUnresolved* instruction) {
+  // HGraphVisitor does not delegate to the abstract HInvoke, so generic invoke injections are checked explicitly
+  VisitInvoke(instruction);
+}
+#endif
+
 void HInjectionVisitor::VisitInvokeInterface(HInvokeInterface* instruction) {
   DCHECK(instruction != nullptr);
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_INTERFACE);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_INTERFACE);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeInterface() Injections #" << checkInjections.size()
                 << " INVOKED: " << GetInvokedMethod(instruction);
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeInterface() DONE";
 }
 
 void HInjectionVisitor::VisitInvokeStaticOrDirect(HInvokeStaticOrDirect* instruction) {
   DCHECK(instruction != nullptr);
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_STATIC_OR_DIRECT);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_STATIC_OR_DIRECT);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeStaticOrDirect() Injections #" << checkInjections.size()
                 << " INVOKED: " << GetInvokedMethod(instruction);
 
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeStaticOrDirect() DONE";
 }
 
@@ -232,28 +514,24 @@ void HInjectionVisitor::VisitInvokeVirtual(HInvokeVirtual* instruction) {
   DCHECK(instruction != nullptr);
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeVirtual()";
 
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_VIRTUAL);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_INVOKE_VIRTUAL);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeVirtual() Injections #" << checkInjections.size()
                 << " INVOKED: " << GetInvokedMethod(instruction);
 
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeVirtual() Injections # " << checkInjections.size();
 
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitInvokeVirtual() DONE";
 }
 
 void HInjectionVisitor::VisitReturn(HReturn* instruction) {
   DCHECK(instruction != nullptr);
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_RETURN);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_RETURN);
   VLOG(artistd) << "HInjectionVisitor::VisitReturn() Injections #" << checkInjections.size()
                 << " PARENT: " << this->artist->GetMethodInfo().GetMethodName(true);
 
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitReturn() DONE";
 }
 
@@ -261,14 +539,12 @@ void HInjectionVisitor::VisitReturnVoid(HReturnVoid* instruction) {
   VLOG(artistd) << "HInjectionVisitor::VisitReturnVoid()" << std::flush;
   DCHECK(instruction != nullptr);
 
-  auto checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_RETURN_VOID);
+  auto& checkInjections = artist->GetInjectionTableEntry(VisitorKeys::H_RETURN_VOID);
 
   VLOG(artistd) << "HInjectionVisitor::VisitReturnVoid() Injections #" << checkInjections.size()
                 << " PARENT: " << this->artist->GetMethodInfo().GetMethodName(true);
 
-  for (auto && injection : checkInjections) {
-    this->InjectInstruction(instruction, injection);
-  }
+  InjectInstructions(instruction, checkInjections);
   VLOG(artistd) << "HInjectionVisitor::VisitReturnVoid() DONE";
 }
 
@@ -26,6 +26,7 @@
 #include "optimizing/artist/api/injection/injection_artist.h"
 #include "optimizing/artist/api/injection/injection.h"
 #include "optimizing/artist/api/env/codelib_environment.h"
+#include "optimizing/artist/internal/injection/injection_site_index.h"
 
 namespace art {
 
@@ -34,14 +35,45 @@ class HInjectionVisitor : public HGraphVisitor {
   HInjectionArtist* artist;
   HGraph* graph;
 
+  // injections coalesced into a single dispatcher call per placement, one bit per dispatched codelib method
+  struct DispatchMasks {
+    uint64_t start = 0;
+    uint64_t before = 0;
+    uint64_t after = 0;
+  };
+
  private:
-  void InjectInstruction(HInstruction* instruction, shared_ptr<const Injection>& injection);
+  void InjectInstructions(HInstruction* instruction, const vector<shared_ptr<const Injection>>& injections);
+
+  void InjectInstruction(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                         DispatchMasks* masks);
+
+  void InjectDispatch(HInstruction* instruction, InjectionTarget target_type, uint64_t mask);
+
+  void GetCallLocation(HInstruction* instruction, InjectionTarget target_type, const Injection* injection,
+                       HInstruction** location, bool* before);
+
+  HInstruction* GetGuardLocation(HInstruction* instruction, InjectionTarget target_type);
 
-  string GetInvokedMethod(HInstruction* instruction);
+  bool InjectLoopInstruction(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                             HLoopInformation* loop_info);
+
+  bool HoistInjection(HInstruction* instruction, const shared_ptr<const Injection>& injection);
+
+  bool AggregateInjection(HInstruction* instruction, const shared_ptr<const Injection>& injection,
+                          HLoopInformation* loop_info);
+
+  const string& GetInvokedMethod(HInstruction* instruction);
 
  public:
   explicit HInjectionVisitor(HInjectionArtist* parent_artist, HGraph* method_graph);
 
+  /**
+   * Visits the given injection sites instead of the whole graph. Sites without any injection for their kind are
+   * skipped without dispatching.
+   */
+  void VisitSites(const InjectionSiteIndex& sites);
+
  public:
   static bool MethodSignatureStartsWith(const string& method_signature, const string& search_string);
 
@@ -52,6 +84,9 @@ class HInjectionVisitor : public HGraphVisitor {
   virtual void VisitInvokeInterface(HInvokeInterface* instruction) OVERRIDE;
   virtual void VisitInvokeStaticOrDirect(HInvokeStaticOrDirect* instruction) OVERRIDE;
   virtual void VisitInvokeVirtual(HInvokeVirtual* instruction) OVERRIDE;
+#ifndef BUILD_MARSHMALLOW
+  virtual void VisitInvokeUnresolved(HInvokeUnresolved* instruction) OVERRIDE;
+#endif
   virtual void VisitReturn(HReturn* instruction) OVERRIDE;
   virtual void VisitReturnVoid(HReturnVoid* instruction) OVERRIDE;
 };
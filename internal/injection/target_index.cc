@@ -0,0 +1,189 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "target_index.h"
+#include "base/logging.h"
+#include "dex_instruction-inl.h"
+#include "utils.h"
+#include "optimizing/artist/internal/utils/method_signature_cache.h"
+
+using std::call_once;
+
+namespace art {
+
+TargetIndex::TargetIndex(const vector<shared_ptr<const Injection>>& injections,
+                         const vector<const DexFile*>& dex_files) : _has_match_all_target(false) {
+  for (auto && injection : injections) {
+    for (auto && target : injection->GetInjectionTargets()) {
+      const Target* key = target.get();
+      if (target->GetTargetType() == InjectionTarget::NO_INJECTION || _targets.count(key) != 0) {
+        continue;
+      }
+      TargetInfo info;
+      info.signature = target->GetTargetSignature();
+      info.generic = info.signature == Target::GENERIC_TARGET;
+      info.pretty = target->GetTargetType() == InjectionTarget::METHOD_START
+                    || target->GetTargetType() == InjectionTarget::METHOD_END;
+      info.ordinal = _indexed_targets.size();
+      _has_match_all_target |= info.generic || info.signature.empty();
+      if (!info.generic) {
+        _indexed_targets.push_back(key);
+      }
+      _targets.emplace(key, info);
+    }
+  }
+
+  for (int flavor = 0; flavor < 2; flavor++) {
+    vector<string> patterns;
+    for (auto target : _indexed_targets) {
+      const TargetInfo& info = _targets.at(target);
+      if (info.pretty == (flavor == 1)) {
+        patterns.push_back(info.signature);
+        _matchers[flavor].ordinals.push_back(info.ordinal);
+      }
+    }
+    if (!patterns.empty()) {
+      _matchers[flavor].automaton.reset(new AhoCorasick(patterns));
+    }
+  }
+
+  for (auto dex_file : dex_files) {
+    _dex_matches[dex_file].reset(new DexMatches());
+  }
+}
+
+bool TargetIndex::Matches(const Target* target, const DexFile* dex_file, MethodIdx method_idx) const {
+  auto target_info = _targets.find(target);
+  CHECK(target_info != _targets.end());
+  const TargetInfo& info = target_info->second;
+  if (info.generic) {
+    return true;
+  }
+  if (method_idx == DexFile::kDexNoIndex) {
+    // same as searching for the target signature in an empty signature
+    return info.signature.empty();
+  }
+
+  auto entry = GetDexMatches(dex_file);
+  if (entry == nullptr) {
+    // not an app dex file, so there is no index. Should not happen but is still handled correctly.
+    return MatchesSignature(info, *dex_file, method_idx);
+  }
+  return entry->matches[info.ordinal][method_idx];
+}
+
+bool TargetIndex::MayHaveInjectionSites(const DexFile* dex_file, MethodIdx method_idx,
+                                        const DexFile::CodeItem* code_item) const {
+  auto entry = GetDexMatches(dex_file);
+  if (_has_match_all_target || entry == nullptr || code_item == nullptr) {
+    return true;
+  }
+  if (entry->methods[method_idx]) {
+    return true;
+  }
+  if (_matchers[0].automaton == nullptr) {
+    // no call targets
+    return false;
+  }
+
+  const uint16_t* insns = code_item->insns_;
+  const uint32_t insns_size = code_item->insns_size_in_code_units_;
+  for (uint32_t dex_pc = 0; dex_pc < insns_size;) {
+    const Instruction* instruction = Instruction::At(insns + dex_pc);
+    switch (instruction->Opcode()) {
+      case Instruction::INVOKE_VIRTUAL:
+      case Instruction::INVOKE_SUPER:
+      case Instruction::INVOKE_DIRECT:
+      case Instruction::INVOKE_STATIC:
+      case Instruction::INVOKE_INTERFACE:
+        if (entry->callees[instruction->VRegB_35c()]) {
+          return true;
+        }
+        break;
+      case Instruction::INVOKE_VIRTUAL_RANGE:
+      case Instruction::INVOKE_SUPER_RANGE:
+      case Instruction::INVOKE_DIRECT_RANGE:
+      case Instruction::INVOKE_STATIC_RANGE:
+      case Instruction::INVOKE_INTERFACE_RANGE:
+        if (entry->callees[instruction->VRegB_3rc()]) {
+          return true;
+        }
+        break;
+      case Instruction::INVOKE_VIRTUAL_QUICK:
+      case Instruction::INVOKE_VIRTUAL_RANGE_QUICK:
+        // quickened invokes do not reference a method id, so we cannot rule them out
+        return true;
+      default:
+        break;
+    }
+    dex_pc += instruction->SizeInCodeUnits();
+  }
+  return false;
+}
+
+const TargetIndex::DexMatches* TargetIndex::GetDexMatches(const DexFile* dex_file) const {
+  auto dex_matches = _dex_matches.find(dex_file);
+  if (dex_matches == _dex_matches.end()) {
+    return nullptr;
+  }
+  DexMatches* entry = dex_matches->second.get();
+  call_once(entry->flag, [this, entry, dex_file]() { Build(dex_file, entry); });
+  return entry;
+}
+
+void TargetIndex::Build(const DexFile* dex_file, DexMatches* result) const {
+  VLOG(artistd) << "TargetIndex: indexing " << _indexed_targets.size() << " targets for " << dex_file->GetLocation();
+  const uint32_t num_methods = dex_file->NumMethodIds();
+  result->matches.assign(_indexed_targets.size(), vector<bool>(num_methods, false));
+  result->callees.assign(num_methods, false);
+  result->methods.assign(num_methods, false);
+  for (int flavor = 0; flavor < 2; flavor++) {
+    const FlavorMatcher& matcher = _matchers[flavor];
+    if (matcher.automaton == nullptr) {
+      continue;
+    }
+    vector<bool>& any_match = flavor == 1 ? result->methods : result->callees;
+    vector<bool> matched(matcher.ordinals.size());
+    for (uint32_t method_idx = 0; method_idx < num_methods; method_idx++) {
+      matched.assign(matched.size(), false);
+      matcher.automaton->Match(GetSignature(*dex_file, method_idx, flavor == 1), &matched);
+      for (size_t id = 0; id < matched.size(); id++) {
+        if (matched[id]) {
+          result->matches[matcher.ordinals[id]][method_idx] = true;
+          any_match[method_idx] = true;
+        }
+      }
+    }
+  }
+}
+
+bool TargetIndex::MatchesSignature(const TargetInfo& info, const DexFile& dex_file, MethodIdx method_idx) {
+  const string signature = GetSignature(dex_file, method_idx, info.pretty);
+  return signature.find(info.signature) != string::npos;
+}
+
+string TargetIndex::GetSignature(const DexFile& dex_file, MethodIdx method_idx, bool pretty) {
+  if (pretty) {
+    return PrettyMethod(method_idx, dex_file, true);
+  }
+  // all methods of the dex file are rendered exactly once here, so memoizing them would only cost memory
+  return MethodSignatureCache::Render(dex_file, method_idx);
+}
+
+}  // namespace art
@@ -0,0 +1,132 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_INJECTION_TARGET_INDEX_H_
+#define ART_INTERNAL_INJECTION_TARGET_INDEX_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dex_file.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
+#include "optimizing/artist/api/injection/injection.h"
+#include "optimizing/artist/internal/utils/aho_corasick.h"
+
+using std::map;
+using std::once_flag;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * Pre-resolves injection targets into per-dex-file bitsets over method indices, so that checking whether a method
+ * matches a target is a single bit lookup instead of building the method's signature and searching it for the target
+ * signature.
+ *
+ * A method matches a target if its signature contains the target signature, where call targets are checked against
+ * the dex signature of the callee (@see ArtUtils::GetMethodSignature) and method start/end targets against the pretty
+ * signature of the compiled method (@see MethodInfo::GetMethodName). Generic targets match everything.
+ *
+ * The bitsets of a dex file are built on first use, covering all targets at once: all target signatures of a flavor
+ * are compiled into a single Aho-Corasick automaton, so each method signature is scanned once, no matter how many
+ * targets a module declares. Dex files are registered at
+ * construction, so the index does not change structurally afterwards and can be queried from all threads without
+ * locking.
+ */
+class TargetIndex {
+ public:
+  TargetIndex(const vector<shared_ptr<const Injection>>& injections, const vector<const DexFile*>& dex_files);
+
+  /**
+   * @param target one of the targets of the injections the index was built for
+   * @param method_idx the callee (call targets) or the compiled method (start/end targets), or DexFile::kDexNoIndex if
+   *                   there is no such method, in which case only generic targets match
+   */
+  bool Matches(const Target* target, const DexFile* dex_file, MethodIdx method_idx) const;
+
+  /**
+   * Cheap prefilter that decides whether the given method can contain any injection site, i.e., whether one of the
+   * start/end targets matches the method itself or its code invokes a method that matches one of the call targets.
+   * Generic (or empty) targets match everything, so they disable the prefilter.
+   *
+   * Only the method's original dex code is scanned, so invokes added to the graph by earlier passes (of any module)
+   * are never considered. This matches the injection site index (@see InjectionSiteIndex), which is shared by all
+   * passes of a method and likewise does not pick up instructions injected after it was collected. Modules therefore
+   * cannot rely on instrumenting code injected by other modules, independent of the prefilter.
+   *
+   * @param code_item the method's code, may be nullptr in which case the result is conservatively true
+   * @return false only if the injection visitor would provably not inject anything into the method
+   */
+  bool MayHaveInjectionSites(const DexFile* dex_file, MethodIdx method_idx, const DexFile::CodeItem* code_item) const;
+
+ private:
+  struct TargetInfo {
+    string signature;
+    // generic targets match any method
+    bool generic;
+    // whether the target is matched against pretty signatures instead of dex signatures
+    bool pretty;
+    // position in the per-dex bitsets
+    size_t ordinal;
+  };
+
+  // the bitsets of a single dex file, indexed by target ordinal and method idx
+  struct DexMatches {
+    once_flag flag;
+    vector<vector<bool>> matches;
+    // union of the call target bitsets: methods whose invocation is an injection site
+    vector<bool> callees;
+    // union of the start/end target bitsets: methods that are injection sites themselves
+    vector<bool> methods;
+  };
+
+  // @return the (built) bitsets for dex_file or nullptr if dex_file is not indexed
+  const DexMatches* GetDexMatches(const DexFile* dex_file) const;
+  void Build(const DexFile* dex_file, DexMatches* result) const;
+  static bool MatchesSignature(const TargetInfo& info, const DexFile& dex_file, MethodIdx method_idx);
+  static string GetSignature(const DexFile& dex_file, MethodIdx method_idx, bool pretty);
+
+  // matches all non-generic targets of a signature flavor, pattern ids are mapped back to target ordinals
+  struct FlavorMatcher {
+    unique_ptr<const AhoCorasick> automaton;
+    vector<size_t> ordinals;
+  };
+
+  unordered_map<const Target*, TargetInfo> _targets;
+  // non-generic targets, indexed by ordinal
+  vector<const Target*> _indexed_targets;
+  // [0]: dex signatures, [1]: pretty signatures
+  FlavorMatcher _matchers[2];
+  // whether there is a target that matches any method, which defeats prefiltering
+  bool _has_match_all_target;
+  // keys are registered in the constructor and never change afterwards, hence lookups do not need locking
+  map<const DexFile*, unique_ptr<DexMatches>> _dex_matches;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_INJECTION_TARGET_INDEX_H_
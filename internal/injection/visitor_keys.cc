@@ -23,12 +23,18 @@
 
 namespace art {
 
-const std::string VisitorKeys::H_INVOKE = "HInvoke";
-const std::string VisitorKeys::H_INVOKE_INTERFACE = "HInvokeInterface";
-const std::string VisitorKeys::H_INVOKE_STATIC_OR_DIRECT = "HInvokeStaticOrDirect";
-const std::string VisitorKeys::H_INVOKE_VIRTUAL = "HInvokeVirtual";
+const char* const VisitorKeys::NAMES[VisitorKeys::NUM_KEYS] = {
+    "HInvoke",
+    "HInvokeInterface",
+    "HInvokeStaticOrDirect",
+    "HInvokeVirtual",
 
-const std::string VisitorKeys::H_RETURN = "HReturn";
-const std::string VisitorKeys::H_RETURN_VOID = "HReturnVoid";
+    "HReturn",
+    "HReturnVoid",
+};
+
+const char* VisitorKeys::GetName(Key key) {
+  return key < NUM_KEYS ? NAMES[key] : "<invalid>";
+}
 
 }  // namespace art
@@ -22,21 +22,32 @@
 #ifndef ART_INTERNAL_INJECTION_VISITOR_KEYS_H_
 #define ART_INTERNAL_INJECTION_VISITOR_KEYS_H_
 
-#include <string>
-
-using std::string;
+#include <cstddef>
 
 namespace art {
 
+/**
+ * The instruction kinds visited by the injection visitor. Keys are dense, so per-key data can be kept in plain arrays
+ * of size NUM_KEYS.
+ */
 class VisitorKeys {
  public:
-  static const string H_INVOKE;
-  static const string H_INVOKE_INTERFACE;
-  static const string H_INVOKE_STATIC_OR_DIRECT;
-  static const string H_INVOKE_VIRTUAL;
+  enum Key {
+    H_INVOKE = 0,
+    H_INVOKE_INTERFACE,
+    H_INVOKE_STATIC_OR_DIRECT,
+    H_INVOKE_VIRTUAL,
+
+    H_RETURN,
+    H_RETURN_VOID,
+
+    NUM_KEYS
+  };
+
+  static const char* GetName(Key key);
 
-  static const string H_RETURN;
-  static const string H_RETURN_VOID;
+ private:
+  static const char* const NAMES[NUM_KEYS];
 };
 
 }  // namespace art
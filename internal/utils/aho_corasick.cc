@@ -0,0 +1,121 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <algorithm>
+#include <deque>
+
+#include "aho_corasick.h"
+#include "base/logging.h"
+
+using std::deque;
+using std::lower_bound;
+using std::make_pair;
+
+namespace art {
+
+const uint32_t AhoCorasick::NONE = 0xFFFFFFFF;
+
+AhoCorasick::AhoCorasick(const vector<string>& patterns) : _num_patterns(patterns.size()), _states(1) {
+  _states[ROOT].output_link = NONE;
+  for (uint32_t id = 0; id < patterns.size(); id++) {
+    AddPattern(patterns[id], id);
+  }
+  Link();
+  VLOG(artistd) << "AhoCorasick: compiled " << _num_patterns << " patterns into " << _states.size() << " states";
+}
+
+size_t AhoCorasick::NumPatterns() const {
+  return _num_patterns;
+}
+
+uint32_t AhoCorasick::Find(uint32_t state, uint8_t c) const {
+  auto& edges = _states[state].edges;
+  auto edge = lower_bound(edges.begin(), edges.end(), make_pair(c, static_cast<uint32_t>(0)));
+  if (edge == edges.end() || edge->first != c) {
+    return NONE;
+  }
+  return edge->second;
+}
+
+uint32_t AhoCorasick::Step(uint32_t state, uint8_t c) const {
+  while (true) {
+    uint32_t next = Find(state, c);
+    if (next != NONE) {
+      return next;
+    }
+    if (state == ROOT) {
+      return ROOT;
+    }
+    state = _states[state].failure;
+  }
+}
+
+void AhoCorasick::AddPattern(const string& pattern, uint32_t id) {
+  uint32_t state = ROOT;
+  for (char character : pattern) {
+    const uint8_t c = static_cast<uint8_t>(character);
+    uint32_t next = Find(state, c);
+    if (next == NONE) {
+      next = static_cast<uint32_t>(_states.size());
+      _states.emplace_back();
+      auto& edges = _states[state].edges;
+      edges.insert(lower_bound(edges.begin(), edges.end(), make_pair(c, static_cast<uint32_t>(0))), make_pair(c, next));
+    }
+    state = next;
+  }
+  _states[state].outputs.push_back(id);
+}
+
+void AhoCorasick::Link() {
+  // breadth-first, so failure links always point to already linked (shallower) states
+  deque<uint32_t> queue;
+  for (auto && edge : _states[ROOT].edges) {
+    _states[edge.second].failure = ROOT;
+    queue.push_back(edge.second);
+  }
+  while (!queue.empty()) {
+    const uint32_t state = queue.front();
+    queue.pop_front();
+    const uint32_t failure = _states[state].failure;
+    _states[state].output_link = _states[failure].outputs.empty() ? _states[failure].output_link : failure;
+    for (auto && edge : _states[state].edges) {
+      _states[edge.second].failure = Step(failure, edge.first);
+      queue.push_back(edge.second);
+    }
+  }
+}
+
+void AhoCorasick::Match(const StringPiece& text, vector<bool>* matched) const {
+  DCHECK_EQ(matched->size(), _num_patterns);
+  // empty patterns are contained in every text
+  for (auto id : _states[ROOT].outputs) {
+    (*matched)[id] = true;
+  }
+  uint32_t state = ROOT;
+  for (size_t i = 0; i < text.size(); i++) {
+    state = Step(state, static_cast<uint8_t>(text[i]));
+    for (uint32_t output = state; output != NONE && output != ROOT; output = _states[output].output_link) {
+      for (auto id : _states[output].outputs) {
+        (*matched)[id] = true;
+      }
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,82 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_UTILS_AHO_CORASICK_H_
+#define ART_INTERNAL_UTILS_AHO_CORASICK_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stringpiece.h"
+
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace art {
+
+/**
+ * Aho-Corasick automaton that finds all occurrences of a fixed set of patterns in a text with a single pass over the
+ * text, independent of the number of patterns.
+ *
+ * Transitions are stored sparsely (sorted per state), since the automata built from method signatures have many
+ * states but only few outgoing edges per state. The automaton is immutable after construction and can be shared
+ * between threads.
+ */
+class AhoCorasick {
+ public:
+  explicit AhoCorasick(const vector<string>& patterns);
+
+  size_t NumPatterns() const;
+
+  /**
+   * Marks every pattern that occurs in `text`, i.e., sets (*matched)[i] to true if patterns[i] is a substring of text.
+   * Entries of patterns that do not occur are left untouched, so callers reset `matched` between texts.
+   *
+   * @param matched must have NumPatterns() entries
+   */
+  void Match(const StringPiece& text, vector<bool>* matched) const;
+
+ private:
+  static const uint32_t ROOT = 0;
+  static const uint32_t NONE;
+
+  struct State {
+    // sorted by character
+    vector<pair<uint8_t, uint32_t>> edges;
+    uint32_t failure = ROOT;
+    // nearest state on the failure chain that has outputs
+    uint32_t output_link;
+    // patterns ending in this state
+    vector<uint32_t> outputs;
+  };
+
+  uint32_t Find(uint32_t state, uint8_t c) const;
+  uint32_t Step(uint32_t state, uint8_t c) const;
+  void AddPattern(const string& pattern, uint32_t id);
+  void Link();
+
+  const size_t _num_patterns;
+  vector<State> _states;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_UTILS_AHO_CORASICK_H_
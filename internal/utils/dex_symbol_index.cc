@@ -0,0 +1,224 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <map>
+#include <mutex>
+
+#include "dex_symbol_index.h"
+#include "base/logging.h"
+#include "optimizing/artist/api/env/java_env.h"
+
+using std::call_once;
+using std::lock_guard;
+using std::make_shared;
+using std::map;
+using std::mutex;
+using std::once_flag;
+using std::unique_ptr;
+
+namespace art {
+
+static const size_t FNV_OFFSET_BASIS = static_cast<size_t>(14695981039346656037ULL);
+static const size_t FNV_PRIME = static_cast<size_t>(1099511628211ULL);
+
+static size_t HashBytes(size_t hash, const StringPiece& piece) {
+  for (size_t i = 0; i < piece.size(); i++) {
+    hash ^= static_cast<uint8_t>(piece.data()[i]);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+size_t StringPieceHash::operator()(const StringPiece& piece) const {
+  return HashBytes(FNV_OFFSET_BASIS, piece);
+}
+
+bool DexSymbolIndex::MemberKey::operator==(const MemberKey& other) const {
+  return type == other.type && name == other.name && proto == other.proto;
+}
+
+size_t DexSymbolIndex::MemberKeyHash::operator()(const MemberKey& key) const {
+  // hashing the parts consecutively yields the same value as hashing the flat signature
+  return HashBytes(HashBytes(HashBytes(FNV_OFFSET_BASIS, key.type), key.name), key.proto);
+}
+
+shared_ptr<const DexSymbolIndex> DexSymbolIndex::Get(const DexFile* dex_file) {
+  CHECK(dex_file != nullptr);
+  struct Entry {
+    once_flag flag;
+    shared_ptr<const DexSymbolIndex> index;
+  };
+  static mutex entries_lock;
+  static map<const DexFile*, unique_ptr<Entry>> entries;
+
+  Entry* entry;
+  {
+    lock_guard<mutex> guard(entries_lock);
+    auto& slot = entries[dex_file];
+    if (slot == nullptr) {
+      slot.reset(new Entry());
+    }
+    entry = slot.get();
+  }
+  // the index is built outside of the registry lock so that different dex files can be indexed concurrently.
+  call_once(entry->flag, [entry, dex_file]() { entry->index = make_shared<const DexSymbolIndex>(dex_file); });
+  return entry->index;
+}
+
+DexSymbolIndex::DexSymbolIndex(const DexFile* dex_file)
+    : _dex_file(dex_file), _protos(dex_file->NumProtoIds()) {
+  VLOG(artistd) << "DexSymbolIndex: indexing " << dex_file->GetLocation();
+
+  _types.reserve(dex_file->NumTypeIds());
+  for (uint32_t i = 0; i < dex_file->NumTypeIds(); i++) {
+    const DexFile::TypeId& type_id = dex_file->GetTypeId(i);
+    _types.emplace(StringPiece(dex_file->GetTypeDescriptor(type_id)), dex_file->GetIndexForTypeId(type_id));
+  }
+
+  _fields.reserve(dex_file->NumFieldIds());
+  for (uint32_t i = 0; i < dex_file->NumFieldIds(); i++) {
+    const DexFile::FieldId& field_id = dex_file->GetFieldId(i);
+    MemberKey key { StringPiece(dex_file->GetFieldTypeDescriptor(field_id)),
+                    StringPiece(dex_file->GetFieldName(field_id)),
+                    StringPiece() };
+    _fields.emplace(key, dex_file->GetIndexForFieldId(field_id));
+  }
+
+  _methods.reserve(dex_file->NumMethodIds());
+  for (uint32_t i = 0; i < dex_file->NumMethodIds(); i++) {
+    const DexFile::MethodId& method_id = dex_file->GetMethodId(i);
+    // prototypes are not stored as flat strings in the dex file, so we render each of them once.
+    string& proto = _protos[method_id.proto_idx_];
+    if (proto.empty()) {
+      proto = dex_file->GetMethodSignature(method_id).ToString();
+    }
+    MemberKey key { StringPiece(dex_file->GetMethodDeclaringClassDescriptor(method_id)),
+                    StringPiece(dex_file->GetMethodName(method_id)),
+                    StringPiece(proto) };
+    _methods.emplace(key, dex_file->GetIndexForMethodId(method_id));
+  }
+
+  _class_defs.reserve(dex_file->NumClassDefs());
+  for (uint32_t idx = 0; idx < dex_file->NumClassDefs(); idx++) {
+    const DexFile::ClassDef& class_def = dex_file->GetClassDef(idx);
+    _class_defs.emplace(StringPiece(dex_file->StringByTypeIdx(class_def.class_idx_)), idx);
+  }
+
+  VLOG(artistd) << "DexSymbolIndex: indexed " << _types.size() << " types, " << _fields.size() << " fields, "
+                << _methods.size() << " methods and " << _class_defs.size() << " class defs";
+}
+
+const DexFile* DexSymbolIndex::GetDexFile() const {
+  return _dex_file;
+}
+
+bool DexSymbolIndex::FindTypeIdx(const StringPiece& descriptor, TypeIdx* result) const {
+  auto found = _types.find(descriptor);
+  if (found == _types.end()) {
+    return false;
+  }
+  if (result) {
+    *result = found->second;
+  }
+  return true;
+}
+
+bool DexSymbolIndex::FindFieldIdx(const StringPiece& type_and_name, FieldIdx* result) const {
+  MemberKey key;
+  if (!SplitMember(type_and_name, false, &key)) {
+    return false;
+  }
+  auto found = _fields.find(key);
+  if (found == _fields.end()) {
+    return false;
+  }
+  if (result) {
+    *result = found->second;
+  }
+  return true;
+}
+
+bool DexSymbolIndex::FindMethodIdx(const StringPiece& signature, MethodIdx* result) const {
+  MemberKey key;
+  if (!SplitMember(signature, true, &key)) {
+    return false;
+  }
+  auto found = _methods.find(key);
+  if (found == _methods.end()) {
+    return false;
+  }
+  if (result) {
+    *result = found->second;
+  }
+  return true;
+}
+
+bool DexSymbolIndex::FindClassDefIdx(const StringPiece& descriptor, ClassDefIdx* result) const {
+  auto found = _class_defs.find(descriptor);
+  if (found == _class_defs.end()) {
+    return false;
+  }
+  if (result) {
+    *result = found->second;
+  }
+  return true;
+}
+
+size_t DexSymbolIndex::DescriptorLength(const StringPiece& signature) {
+  size_t pos = 0;
+  while (pos < signature.size() && signature[pos] == JavaEnvironment::ARRAY) {
+    pos++;
+  }
+  if (pos == signature.size()) {
+    return 0;
+  }
+  if (signature[pos] != JavaEnvironment::CLASS) {
+    // primitive (component) type
+    return pos + 1;
+  }
+  for (; pos < signature.size(); pos++) {
+    if (signature[pos] == JavaEnvironment::CLASS_TERMINATOR) {
+      return pos + 1;
+    }
+  }
+  return 0;
+}
+
+bool DexSymbolIndex::SplitMember(const StringPiece& signature, bool is_method, MemberKey* result) {
+  const size_t type_length = DescriptorLength(signature);
+  if (type_length == 0) {
+    return false;
+  }
+  size_t name_end = signature.size();
+  if (is_method) {
+    name_end = type_length;
+    while (name_end < signature.size() && signature[name_end] != JavaEnvironment::FUNCTION_PARAM_START) {
+      name_end++;
+    }
+    if (name_end == signature.size()) {
+      return false;
+    }
+  }
+  result->type = StringPiece(signature.data(), type_length);
+  result->name = StringPiece(signature.data() + type_length, name_end - type_length);
+  result->proto = StringPiece(signature.data() + name_end, signature.size() - name_end);
+  return true;
+}
+
+}  // namespace art
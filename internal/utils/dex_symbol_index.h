@@ -0,0 +1,117 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_UTILS_DEX_SYMBOL_INDEX_H_
+#define ART_INTERNAL_UTILS_DEX_SYMBOL_INDEX_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/stringpiece.h"
+#include "dex_file.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
+
+using std::shared_ptr;
+using std::string;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * FNV-1a hash over the raw bytes of a StringPiece, so views into dex string data can be used as hash keys without
+ * copying them into a std::string first.
+ */
+struct StringPieceHash {
+  size_t operator()(const StringPiece& piece) const;
+};
+
+/**
+ * Hashed lookup tables for the type, field, method and class def symbols of a single dex file.
+ *
+ * All keys are views into the dex file's string data (or, for method prototypes, into strings owned by the index), so
+ * an index is built by a single pass over each id table and lookups neither scan nor allocate. Like the linear search
+ * it replaces, the lowest index wins if a key occurs more than once.
+ */
+class DexSymbolIndex {
+ public:
+  /**
+   * Provides the index for the given dex file. It is built on first use and shared by all later callers.
+   *
+   * @param dex_file the dex file to be indexed
+   * @return the (immutable) index for dex_file
+   */
+  static shared_ptr<const DexSymbolIndex> Get(const DexFile* dex_file);
+
+  explicit DexSymbolIndex(const DexFile* dex_file);
+
+  const DexFile* GetDexFile() const;
+
+  // descriptor, e.g., `Ljava/lang/String;`
+  bool FindTypeIdx(const StringPiece& descriptor, TypeIdx* result) const;
+  // type descriptor + name, e.g., `Lsaarland/cispa/artist/codelib/CodeLib;INSTANCE`
+  bool FindFieldIdx(const StringPiece& type_and_name, FieldIdx* result) const;
+  // class descriptor + name + prototype, e.g., `Ljava/lang/String;equals(Ljava/lang/Object;)Z`
+  bool FindMethodIdx(const StringPiece& signature, MethodIdx* result) const;
+  // descriptor of the defined class
+  bool FindClassDefIdx(const StringPiece& descriptor, ClassDefIdx* result) const;
+
+ private:
+  // a member symbol split into its parts. `proto` stays empty for fields.
+  struct MemberKey {
+    StringPiece type;
+    StringPiece name;
+    StringPiece proto;
+
+    bool operator==(const MemberKey& other) const;
+  };
+
+  struct MemberKeyHash {
+    size_t operator()(const MemberKey& key) const;
+  };
+
+  /**
+   * Splits a flat member signature (type descriptor, name and, for methods, the prototype starting at `(`) into its
+   * parts. The resulting key points into `signature`.
+   *
+   * @return false if signature is malformed
+   */
+  static bool SplitMember(const StringPiece& signature, bool is_method, MemberKey* result);
+
+  /**
+   * @return length of the type descriptor at the start of `signature` or 0 if there is none
+   */
+  static size_t DescriptorLength(const StringPiece& signature);
+
+  const DexFile* _dex_file;
+
+  // prototype strings, indexed by proto idx. Sized once and never resized since method keys point into them.
+  vector<string> _protos;
+
+  unordered_map<StringPiece, TypeIdx, StringPieceHash> _types;
+  unordered_map<MemberKey, FieldIdx, MemberKeyHash> _fields;
+  unordered_map<MemberKey, MethodIdx, MemberKeyHash> _methods;
+  unordered_map<StringPiece, ClassDefIdx, StringPieceHash> _class_defs;
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_UTILS_DEX_SYMBOL_INDEX_H_
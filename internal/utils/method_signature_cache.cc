@@ -0,0 +1,68 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "method_signature_cache.h"
+#include "base/logging.h"
+#include "optimizing/artist/api/env/signature_interner.h"
+
+using std::memory_order_acquire;
+using std::memory_order_release;
+
+namespace art {
+
+unordered_map<const DexFile*, unique_ptr<MethodSignatureCache::Slots>>& MethodSignatureCache::GetSlots() {
+  static unordered_map<const DexFile*, unique_ptr<Slots>> slots;
+  return slots;
+}
+
+void MethodSignatureCache::Register(const vector<const DexFile*>& dex_files) {
+  auto& slots = GetSlots();
+  CHECK(slots.empty());
+  for (auto dex_file : dex_files) {
+    slots[dex_file].reset(new Slots(dex_file->NumMethodIds()));
+  }
+}
+
+const string& MethodSignatureCache::Get(const DexFile& dex_file, MethodIdx method_idx) {
+  auto& interner = SignatureInterner::getInstance();
+  auto& slots = GetSlots();
+  auto found = slots.find(&dex_file);
+  if (found == slots.end()) {
+    // not registered: the interner still keeps the signature alive for us, it is just not memoized per method id.
+    return interner.resolve(interner.intern(Render(dex_file, method_idx)));
+  }
+
+  atomic<const string*>& slot = found->second->signatures[method_idx];
+  const string* signature = slot.load(memory_order_acquire);
+  if (signature == nullptr) {
+    // racing threads intern the same string and hence publish the same pointer, so a plain store is sufficient.
+    signature = &interner.resolve(interner.intern(Render(dex_file, method_idx)));
+    slot.store(signature, memory_order_release);
+  }
+  return *signature;
+}
+
+string MethodSignatureCache::Render(const DexFile& dex_file, MethodIdx method_idx) {
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  const char* method_class = dex_file.GetMethodDeclaringClassDescriptor(method_id);
+  const char* method_name = dex_file.GetMethodName(method_id);
+  return string(method_class) + method_name + dex_file.GetMethodSignature(method_id).ToString();
+}
+
+}  // namespace art
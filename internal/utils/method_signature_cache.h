@@ -0,0 +1,81 @@
+/**
+ * The ARTist Project (https://artist.cispa.saarland)
+ *
+ * Copyright (C) 2017 CISPA (https://cispa.saarland), Saarland University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef ART_INTERNAL_UTILS_METHOD_SIGNATURE_CACHE_H_
+#define ART_INTERNAL_UTILS_METHOD_SIGNATURE_CACHE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dex_file.h"
+#include "optimizing/artist/api/env/artist_typedefs.h"
+
+using std::atomic;
+using std::string;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+namespace art {
+
+/**
+ * Memoizes the flat signatures (class descriptor + name + prototype, e.g., `Landroid/util/Log;d(...)I`) of method ids.
+ *
+ * Popular callees are looked up over and over again while instrumenting an app, so each signature is rendered once
+ * per dex file and then interned (@see SignatureInterner), which keeps it alive and at a stable address. The slots of
+ * a dex file are filled lazily and published atomically, so reads never take a lock. Dex files are registered before
+ * compilation starts, the registry itself is not modified afterwards.
+ */
+class MethodSignatureCache {
+ public:
+  /**
+   * Registers the dex files whose signatures are cached. Must be called a single time, before any compiler thread
+   * queries the cache.
+   */
+  static void Register(const vector<const DexFile*>& dex_files);
+
+  /**
+   * @return the signature of method_idx in dex_file
+   */
+  static const string& Get(const DexFile& dex_file, MethodIdx method_idx);
+
+  /**
+   * Renders the signature without caching it, e.g., for one-off passes over all methods of a dex file.
+   */
+  static string Render(const DexFile& dex_file, MethodIdx method_idx);
+
+ private:
+  struct Slots {
+    explicit Slots(size_t size) : signatures(new atomic<const string*>[size]) {
+      for (size_t i = 0; i < size; i++) {
+        signatures[i].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+    unique_ptr<atomic<const string*>[]> signatures;
+  };
+
+  static unordered_map<const DexFile*, unique_ptr<Slots>>& GetSlots();
+};
+
+}  // namespace art
+
+#endif  // ART_INTERNAL_UTILS_METHOD_SIGNATURE_CACHE_H_